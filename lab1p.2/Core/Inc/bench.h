@@ -0,0 +1,28 @@
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Кількість повторів у кожному вимірюванні
+#define BENCH_ITERATIONS 1000
+
+// 1 - додати BENCH SNPRINTF (snprintf newlib) для порівняння з BENCH FMT
+#define BENCH_NEWLIB_PRINTF 0
+
+// Лічильник тактів ядра (DWT CYCCNT), 84 такти на мікросекунду
+static inline uint32_t Bench_Now(void) {
+    return DWT->CYCCNT;
+}
+
+void Bench_Init(void);
+uint8_t Bench_Run(const char *name, char *response, uint16_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H */
@@ -0,0 +1,28 @@
+#ifndef __BOOT_H
+#define __BOOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+#define BOOT_MAX_STAGES  16
+
+// Етап завантаження і час від скидання до його кінця, мкс
+typedef struct {
+    const char *name;
+    uint32_t us;
+} BootStage;
+
+void Boot_ClockInit(void);
+void Boot_Start(void);
+void Boot_Mark(const char *name);
+uint8_t Boot_Count(void);
+const BootStage *Boot_Stage(uint8_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOT_H */
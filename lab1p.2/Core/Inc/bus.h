@@ -0,0 +1,33 @@
+#ifndef __BUS_H
+#define __BUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Формат адресного байта (8 біт даних, адресна мітка - старший біт):
+//   bit 7    - 1, ознака адресного байта (команди - лише 7-бітний ASCII)
+//   bit 6..4 - номер вузла в групі, BUS_UNIT_ALL - усі вузли групи
+//   bit 3..0 - адреса групи, порівнюється апаратно з USART_CR2.ADD
+#define BUS_ADDRESS_MARK   0x80
+#define BUS_UNIT_ALL       0x7
+#define BUS_ADDRESS(group, unit) \
+    (uint8_t)(BUS_ADDRESS_MARK | (((unit) & 0x7) << 4) | ((group) & 0xF))
+
+// Результат розбору адресного байта
+#define BUS_FRAME_NONE   0 // Кадр іншого вузла
+#define BUS_FRAME_UNIT   1 // Кадр саме цьому вузлу
+#define BUS_FRAME_GROUP  2 // Груповий кадр, без відповіді
+
+void Bus_Init(UART_HandleTypeDef *huart);
+uint8_t Bus_IsAddressByte(uint8_t data);
+uint8_t Bus_SelectFrame(uint8_t address);
+void Bus_EndFrame(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BUS_H */
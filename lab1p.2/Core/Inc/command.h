@@ -0,0 +1,17 @@
+#ifndef __COMMAND_H
+#define __COMMAND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "uart_link.h"
+
+void Command_Execute(const UartLine *line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __COMMAND_H */
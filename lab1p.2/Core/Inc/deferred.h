@@ -0,0 +1,44 @@
+#ifndef __DEFERRED_H
+#define __DEFERRED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+#define DEFERRED_QUEUE_SIZE  8 // Степінь двійки
+#define DEFERRED_MAX_QUEUES  8
+
+typedef void (*DeferredHandler)(uint32_t data);
+
+// Черга відкладеної роботи одного джерела: пише одне переривання,
+// читає лише PendSV
+typedef struct {
+    DeferredHandler handler;
+    uint32_t data[DEFERRED_QUEUE_SIZE];
+    uint32_t posted[DEFERRED_QUEUE_SIZE]; // DWT CYCCNT у момент запису
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    uint8_t priority;                     // Більше - обробляється раніше
+} DeferredQueue;
+
+typedef struct {
+    uint32_t items;       // Виконано нижніх половин
+    uint32_t dropped;     // Черга джерела була повна
+    uint32_t busyCycles;  // Загальний час у PendSV (зайнятість)
+    uint32_t maxCycles;   // Найдовший прохід PendSV
+    uint32_t maxLatency;  // Найбільша затримка від запису до виконання
+} DeferredStats;
+
+void Deferred_Init(void);
+void Deferred_Register(DeferredQueue *queue, uint8_t priority);
+uint8_t Deferred_Post(DeferredQueue *queue, uint32_t data);
+void Deferred_Drain(void);
+void Deferred_GetStats(DeferredStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DEFERRED_H */
@@ -0,0 +1,22 @@
+#ifndef __DVFS_H
+#define __DVFS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+#define DVFS_HOLD_MS   500    // Повна частота тримається після останньої активності
+#define DVFS_TIM2_HZ   500000 // Частота лічби TIM2 (PWM 500 Гц при ARR = 999)
+#define DVFS_RETRY_MS  2      // Повтор перемикання, відкладеного через прийом (~2 кадри)
+
+void Dvfs_Init(void);
+void Dvfs_Boost(void);
+uint8_t Dvfs_IsHigh(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DVFS_H */
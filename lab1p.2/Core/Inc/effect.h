@@ -0,0 +1,24 @@
+#ifndef __EFFECT_H
+#define __EFFECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+#define EFFECT_STEP_MS  10    // Крок оновлення яскравості під час ефекту
+#define EFFECT_MAX_MS   60000 // Найдовший ефект
+
+void Effect_StartFade(uint8_t target, uint32_t durationMs);
+void Effect_Stop(void);
+void Effect_Resume(void);
+uint8_t Effect_IsRunning(void);
+uint8_t Effect_Target(void);
+void Effect_DoneCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EFFECT_H */
@@ -0,0 +1,41 @@
+#ifndef __EVENT_QUEUE_H
+#define __EVENT_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+#define EVENT_QUEUE_SIZE 16 // Степінь двійки
+
+typedef struct {
+    uint16_t type;
+    uint16_t arg;
+    uint32_t data;
+} Event;
+
+typedef struct {
+    volatile uint32_t sequence; // Номер позиції, для якої слот вільний/заповнений
+    Event event;
+} EventSlot;
+
+// Обмежена черга: пишуть кілька переривань (з різними пріоритетами),
+// читає один споживач - головний цикл
+typedef struct {
+    EventSlot slots[EVENT_QUEUE_SIZE];
+    volatile uint32_t head;    // Наступна позиція запису (LDREX/STREX)
+    uint32_t tail;             // Наступна позиція читання (лише споживач)
+    volatile uint32_t dropped; // Подій не вмістилось
+} EventQueue;
+
+void EventQueue_Init(EventQueue *queue);
+uint8_t EventQueue_Post(EventQueue *queue, uint16_t type, uint16_t arg, uint32_t data);
+uint8_t EventQueue_Take(EventQueue *queue, Event *event);
+uint32_t EventQueue_Dropped(const EventQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_QUEUE_H */
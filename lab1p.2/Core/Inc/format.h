@@ -0,0 +1,27 @@
+#ifndef __FORMAT_H
+#define __FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include <stdarg.h>
+
+// Приймач символів: буфер, черга TX тощо
+typedef void (*FormatPut)(void *context, char c);
+
+// Формат перевіряє компілятор (атрибут format). Підтримуються лише
+// %d %i %u %x %X %c %s %% з прапорцями '0' і '-', шириною і
+// модифікатором l; інші перетворення виводяться як '?'.
+uint16_t Format_Vprint(FormatPut put, void *context, const char *format, va_list args);
+uint16_t Format_Print(FormatPut put, void *context, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+uint16_t Format_Buffer(char *buffer, uint16_t size, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FORMAT_H */
@@ -0,0 +1,58 @@
+#ifndef __HSM_H
+#define __HSM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "event_queue.h"
+
+#define HSM_MAX_STATES   12
+#define HSM_MAX_EVENTS   8    // Типи подій 0..HSM_MAX_EVENTS-1
+#define HSM_MAX_DEPTH    6    // Рівнів ієрархії разом із коренем
+#define HSM_NONE         0xFF // Немає стану (батько кореня, немає початкового)
+#define HSM_INTERNAL     0xFE // Внутрішній перехід: без виходу і входу
+
+typedef struct Hsm Hsm;
+typedef void (*HsmAction)(Hsm *hsm, const Event *event);
+
+typedef struct {
+    uint8_t event;
+    uint8_t target;   // Індекс стану або HSM_INTERNAL
+    HsmAction action; // Може бути NULL
+} HsmTransition;
+
+// Опис стану; таблиці оголошуються як const і лишаються у flash
+typedef struct {
+    const char *name;
+    uint8_t parent;
+    uint8_t initial;  // Початковий підстан складеного стану
+    HsmAction entry;
+    HsmAction exit;
+    const HsmTransition *transitions;
+    uint8_t transitionCount;
+} HsmState;
+
+#define HSM_TRANSITIONS(table) (table), (uint8_t)(sizeof(table) / sizeof((table)[0]))
+#define HSM_NO_TRANSITIONS     NULL, 0
+
+struct Hsm {
+    const HsmState *states;
+    uint8_t stateCount;
+    uint8_t current;  // Завжди листовий стан
+    // Таблиця переходів з успадкуванням, зведена під час Hsm_Init
+    const HsmTransition *table[HSM_MAX_STATES][HSM_MAX_EVENTS];
+    void *context;
+};
+
+void Hsm_Init(Hsm *hsm, const HsmState *states, uint8_t stateCount, void *context);
+void Hsm_Start(Hsm *hsm);
+void Hsm_Dispatch(Hsm *hsm, const Event *event);
+uint8_t Hsm_IsIn(const Hsm *hsm, uint8_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HSM_H */
@@ -0,0 +1,68 @@
+#ifndef __ISR_MONITOR_H
+#define __ISR_MONITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Переривання під наглядом
+typedef enum {
+    ISR_MONITOR_BUTTON, // EXTI15_10
+    ISR_MONITOR_UART,   // USART2
+    ISR_MONITOR_DMA,    // DMA1 Stream6
+    ISR_MONITOR_TICK,   // SysTick - єдиний таймер з перериванням
+    ISR_MONITOR_WAKE,   // RTC wakeup
+    ISR_MONITOR_COUNT
+} IsrMonitorIrq;
+
+// Кошики гістограм: <64, <256, <1K, <4K, <16K, <64K, <256K, решта тактів
+#define ISR_MONITOR_BUCKETS     8
+#define ISR_MONITOR_WINDOW_MS   1000       // Вікно оцінки завантаження
+#define ISR_MONITOR_NO_LATENCY  0xFFFFFFFF // Момент запиту невідомий
+
+typedef struct {
+    uint32_t count;
+    uint32_t maxDuration;  // Такти власного виконання (без вкладених)
+    uint32_t maxLatency;
+    uint32_t duration[ISR_MONITOR_BUCKETS];
+    uint32_t latency[ISR_MONITOR_BUCKETS];
+} IsrMonitorStats;
+
+// Точка входу обробника: час і сумарна зайнятість на цей момент
+typedef struct {
+    uint32_t start;
+    uint32_t inner;
+} IsrFrame;
+
+extern volatile uint32_t isrMonitorBusy;
+
+#if ISR_MONITOR_ENABLED
+static inline void IsrMonitor_Enter(IsrFrame *frame) {
+    frame->start = DWT->CYCCNT;
+    frame->inner = isrMonitorBusy;
+}
+
+void IsrMonitor_Exit(const IsrFrame *frame, IsrMonitorIrq irq, uint32_t latency);
+#else
+static inline void IsrMonitor_Enter(IsrFrame *frame) {
+    (void)frame;
+}
+
+static inline void IsrMonitor_Exit(const IsrFrame *frame, IsrMonitorIrq irq, uint32_t latency) {
+    (void)frame;
+    (void)irq;
+    (void)latency;
+}
+#endif
+
+void IsrMonitor_GetStats(IsrMonitorIrq irq, IsrMonitorStats *stats);
+const char *IsrMonitor_Name(IsrMonitorIrq irq);
+uint16_t IsrMonitor_Load(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ISR_MONITOR_H */
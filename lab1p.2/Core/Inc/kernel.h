@@ -0,0 +1,72 @@
+#ifndef __KERNEL_H
+#define __KERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Кількість рівнів пріоритету; на кожному рівні - рівно одна задача,
+// 0 - задача простою ядра, більше число - вищий пріоритет
+#define KERNEL_PRIORITIES     8
+#define KERNEL_WAIT_FOREVER   0xFFFFFFFFUL
+#define KERNEL_IDLE_STACK     128 // Слів
+
+typedef void (*KernelEntry)(void *argument);
+
+typedef struct {
+    uint32_t *sp;             // Збережений PSP; має бути першим полем (PendSV)
+    const char *name;
+    uint8_t priority;
+    uint8_t result;           // 1 - об'єкт отримано, 0 - вийшов тайм-аут
+    uint32_t wakeTick;        // Кінець очікування, тіки HAL
+    volatile uint32_t *waitList; // Маска очікувачів об'єкта, на якому стоїть задача
+} KernelTask;
+
+// Семафор з лічильником; віддавати можна і з переривань
+typedef struct {
+    volatile uint16_t count;
+    uint16_t max;
+    volatile uint32_t waiters; // Біт на пріоритет задачі, що чекає
+} KernelSemaphore;
+
+// Черга фіксованих елементів; з переривань - лише з тайм-аутом 0
+typedef struct {
+    uint8_t *buffer;
+    uint16_t itemSize;
+    uint16_t capacity;
+    volatile uint16_t head;
+    volatile uint16_t count;
+    volatile uint32_t receivers;
+    volatile uint32_t senders;
+} KernelQueue;
+
+typedef struct {
+    uint32_t switches;      // Перемикань контексту
+    uint32_t maxLockCycles; // Найдовша критична секція ядра, такти
+    uint8_t load;           // Завантаження процесора за останню секунду, %
+} KernelStats;
+
+void Kernel_CreateTask(KernelTask *task, const char *name, KernelEntry entry, void *argument,
+                       uint32_t *stack, uint32_t stackWords, uint8_t priority);
+void Kernel_Start(void);
+uint8_t Kernel_IsRunning(void);
+void Kernel_Tick(void);
+void Kernel_Delay(uint32_t ms);
+
+void Kernel_SemInit(KernelSemaphore *sem, uint16_t initial, uint16_t max);
+uint8_t Kernel_SemTake(KernelSemaphore *sem, uint32_t timeout);
+void Kernel_SemGive(KernelSemaphore *sem);
+
+void Kernel_QueueInit(KernelQueue *queue, void *buffer, uint16_t itemSize, uint16_t capacity);
+uint8_t Kernel_QueueSend(KernelQueue *queue, const void *item, uint32_t timeout);
+uint8_t Kernel_QueueReceive(KernelQueue *queue, void *item, uint32_t timeout);
+
+void Kernel_GetStats(KernelStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __KERNEL_H */
@@ -56,6 +56,10 @@ void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim);
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
+extern UART_HandleTypeDef huart2;
+extern TIM_HandleTypeDef htim2;
+extern volatile uint8_t brightness;
+extern volatile uint8_t ledState;
 
 /* USER CODE END EFP */
 
@@ -74,6 +78,57 @@ void Error_Handler(void);
 #define SWO_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
+// План пріоритетів NVIC (NVIC_PRIORITYGROUP_4, менше число - вищий).
+// Порядок визначає жорсткість дедлайну: USART2 RX має лише один байт
+// буфера (~1 мс на 9600 бод до ORE); SysTick лише рахує час і
+// переносить таймери; DMA TX може почекати; кнопка і пробудження не
+// критичні до часу. Уся прикладна робота переривань виконується в
+// PendSV з найнижчим пріоритетом (deferred.c), там же і перемикання
+// задач ядра. Верхні половини мають лишатися коротшими за ~50 мкс.
+#define IRQ_PRIORITY_UART      0  // USART2
+#define IRQ_PRIORITY_TICK      1  // SysTick (TICK_INT_PRIORITY)
+#define IRQ_PRIORITY_DMA       1  // DMA1 Stream6, передача USART2
+#define IRQ_PRIORITY_EXTI      2  // Кнопка B1, старт-біт RX у STOP
+#define IRQ_PRIORITY_TIM       3  // Таймери (TIM2 зараз без переривань)
+#define IRQ_PRIORITY_RTC       3  // Пробудження RTC
+#define IRQ_PRIORITY_DEFERRED  15 // PendSV
+
+// Адресна шина (USART2 у режимі multiprocessor з адресною міткою)
+#define BUS_MODE_ENABLED   0    // 1 - вузол працює на спільній послідовній лінії
+#define BUS_GROUP_ADDRESS  0x1  // Апаратна адреса (група) вузла, 0x0..0xF
+#define BUS_UNIT_ADDRESS   0x0  // Номер вузла в групі, 0..6 (7 - усі вузли групи)
+
+// Витісняльне ядро (kernel.c): 1 - протокол і таймери працюють окремими задачами
+#define KERNEL_ENABLED     0
+
+// Сон без SysTick до найближчого таймера (будить RTC від LSE)
+#define POWER_TICKLESS_ENABLED  1
+// STOP замість сну, коли світлодіод вимкнено (будять кнопка і старт-біт на RX)
+#define POWER_STOP_ENABLED      1
+// Зниження частоти до HSI 16 МГц у простої, PLL 84 МГц під навантаженням
+#define DVFS_ENABLED            1
+
+// Мітки тактів на вході і виході переривань (isr_monitor.c, команда ISR)
+#define ISR_MONITOR_ENABLED     1
+
+// Обробники переривань і те, що вони викликають, виконуються з SRAM
+// (секція .RamFunc у .data, копіює startup): без тактів очікування flash
+// і промахів ART. 0 - усе у flash, щоб порівняти гістограми команди ISR
+#define RAMFUNC_ENABLED         1
+#if RAMFUNC_ENABLED
+#define HOT_FUNC __RAM_FUNC
+#else
+#define HOT_FUNC
+#endif
+
+// Таблиця векторів у SRAM (vectors.c); прийом USART2 тоді йде власним
+// обробником у векторі, без HAL_UART_IRQHandler
+#define VECTORS_RAM_ENABLED     1
+
+// Швидке завантаження: світлодіод зі збереженою яскравістю до решти
+// периферії, вітання без очікування передачі. 0 - світлодіод після
+// периферії і блокуюче вітання, як раніше (порівняння за командою BOOT)
+#define BOOT_FAST_ENABLED       1
 
 /* USER CODE END Private defines */
 
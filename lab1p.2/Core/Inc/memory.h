@@ -0,0 +1,28 @@
+#ifndef __MEMORY_H
+#define __MEMORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Шаблон вільної RAM, яким її заповнює Reset_Handler
+#define MEMORY_PAINT 0xA5A5A5A5UL
+
+typedef struct {
+    uint32_t stackPeak;     // Найбільша глибина стека MSP, байти
+    uint32_t stackReserved; // _Min_Stack_Size з лінкер-скрипта
+    uint32_t heapPeak;      // Віддано newlib через _sbrk (купа не зменшується)
+    uint32_t heapInUse;     // Зайнято malloc зараз (блоки пулів, pool.c)
+    uint32_t freeRam;       // Жодного разу не торкана RAM між купою і стеком
+    uint32_t heapFailures;  // Відмов _sbrk
+} MemoryStats;
+
+void Memory_GetStats(MemoryStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEMORY_H */
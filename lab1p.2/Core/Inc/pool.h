@@ -0,0 +1,46 @@
+#ifndef __POOL_H
+#define __POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+typedef struct PoolBlock {
+    struct PoolBlock *next;
+} PoolBlock;
+
+// Пул блоків однакового розміру; пам'ять виділяє POOL_DEFINE
+typedef struct Pool {
+    const char *name;
+    uint16_t blockSize;    // Байти, кратно 4
+    uint16_t blockCount;
+    uint8_t *storage;
+    PoolBlock *free;       // Список вільних блоків
+    uint16_t used;
+    uint16_t peak;
+    uint32_t failures;     // Запитів, коли пул був порожній
+    struct Pool *nextPool; // Список усіх пулів (команда POOL)
+} Pool;
+
+#define POOL_WORDS(size) (((size) + 3) / 4)
+
+// Статичний пул з count блоків по size байтів
+#define POOL_DEFINE(pool, size, count)                                   \
+    static uint32_t pool##Storage[(count) * POOL_WORDS(size)];            \
+    static Pool pool = { .name = #pool, .blockSize = POOL_WORDS(size) * 4, \
+                         .blockCount = (count), .storage = (uint8_t *)pool##Storage }
+
+void Pool_Init(Pool *pool);
+void *Pool_Alloc(Pool *pool);
+void Pool_Free(Pool *pool, void *block);
+uint8_t Pool_Owns(const Pool *pool, const void *block);
+const Pool *Pool_First(void);
+uint32_t Pool_MallocInUse(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __POOL_H */
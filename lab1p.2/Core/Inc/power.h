@@ -0,0 +1,34 @@
+#ifndef __POWER_H
+#define __POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Без SysTick спимо лише тоді, коли найближчий таймер не раніше, ніж
+// через POWER_TICKLESS_MIN_MS; довший сон ділиться на відрізки
+#define POWER_TICKLESS_MIN_MS  5
+#define POWER_TICKLESS_MAX_MS  30000
+// STOP має сенс лише для довгого простою: вихід із нього і відновлення
+// PLL коштують сотні мікросекунд
+#define POWER_STOP_MIN_MS      50
+
+typedef struct {
+    uint32_t sleeps;       // Сон без SysTick
+    uint32_t stops;        // З них у режимі STOP
+    uint32_t lastWakeUs;   // Відновлення тактування після останнього STOP
+    uint32_t maxWakeUs;
+} PowerStats;
+
+void Power_Init(void);
+void Power_Idle(void);
+void Power_WakeupIRQHandler(void);
+void Power_GetStats(PowerStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __POWER_H */
@@ -0,0 +1,66 @@
+#ifndef __PT_H
+#define __PT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "timer_wheel.h"
+
+// Протопотоки (безстекові співпрограми на основі switch/__LINE__).
+// Задача - звичайна функція, що повертає керування на кожному
+// очікуванні і продовжує з того ж місця при наступному виклику.
+// Окремий стек не потрібен: увесь стан - номер рядка в Pt плюс поля,
+// які задача тримає в static-змінних або у власній структурі.
+// Локальні змінні між очікуваннями НЕ зберігаються, а всередині
+// задачі не можна використовувати власний switch.
+
+typedef struct {
+    uint16_t line; // Рядок, з якого продовжити виконання (0 - початок)
+} Pt;
+
+#define PT_WAITING 0 // Задача чекає на подію
+#define PT_ENDED   1 // Задача дійшла до PT_END
+
+#define PT_INIT(pt)   ((pt)->line = 0)
+
+#define PT_BEGIN(pt)  switch ((pt)->line) { case 0:
+
+#define PT_END(pt)    } (pt)->line = 0; return PT_ENDED
+
+// Чекати, поки умова не стане істинною
+#define PT_WAIT_UNTIL(pt, condition)                  \
+    do {                                              \
+        (pt)->line = __LINE__; case __LINE__:         \
+        if (!(condition)) return PT_WAITING;          \
+    } while (0)
+
+#define PT_WAIT_WHILE(pt, condition) PT_WAIT_UNTIL(pt, !(condition))
+
+// Віддати керування іншим задачам один раз
+#define PT_YIELD(pt)                                  \
+    do {                                              \
+        (pt)->line = __LINE__;                        \
+        return PT_WAITING; case __LINE__:;            \
+    } while (0)
+
+// Запустити вкладену задачу і чекати її завершення
+#define PT_SPAWN(pt, child, thread)                   \
+    do {                                              \
+        PT_INIT(child);                               \
+        PT_WAIT_UNTIL(pt, (thread) == PT_ENDED);      \
+    } while (0)
+
+// Затримка через колесо таймерів: timer - static Timer без колбека
+#define PT_DELAY(pt, timer, ms)                       \
+    do {                                              \
+        TimerWheel_Start(timer, ms, 0);               \
+        PT_WAIT_WHILE(pt, TimerWheel_IsActive(timer)); \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PT_H */
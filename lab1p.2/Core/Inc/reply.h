@@ -0,0 +1,42 @@
+#ifndef __REPLY_H
+#define __REPLY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "uart_link.h"
+
+// Режими відповіді (команда V=<n>)
+#define REPLY_SILENT   0 // Лише періодичні кумулятивні підтвердження
+#define REPLY_TERSE    1 // Числовий код результату
+#define REPLY_VERBOSE  2 // Повний текст (за замовчуванням)
+
+// Коди результату команди (у режимі REPLY_TERSE передаються числом)
+typedef enum {
+    REPLY_OK = 0,
+    REPLY_INVALID_VALUE = 1,
+    REPLY_INVALID_COMMAND = 2,
+    REPLY_TOO_LONG = 3
+} ReplyCode;
+
+// Підтвердження в тихому режимі: після REPLY_ACK_EVERY команд або
+// через REPLY_ACK_PERIOD_MS після першої непідтвердженої
+#define REPLY_ACK_EVERY      16
+#define REPLY_ACK_PERIOD_MS  200
+
+void Reply_SetMode(uint8_t mode);
+uint8_t Reply_GetMode(void);
+void Reply_Result(const UartLine *line, ReplyCode code, const char *text);
+void Reply_Text(const UartLine *line, const char *text);
+void Reply_ResultFormat(const UartLine *line, ReplyCode code, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+void Reply_Format(const UartLine *line, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REPLY_H */
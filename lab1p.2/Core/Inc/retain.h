@@ -0,0 +1,22 @@
+#ifndef __RETAIN_H
+#define __RETAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Змінна переживає скидання (сторожовий таймер, NVIC_SystemReset, NRST)
+#define RETAIN_NOINIT __attribute__((section(".noinit")))
+
+void Retain_Init(void);
+uint8_t Retain_IsWarm(void);
+uint8_t Retain_Restore(void);
+void Retain_Save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RETAIN_H */
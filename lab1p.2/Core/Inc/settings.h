@@ -0,0 +1,42 @@
+#ifndef __SETTINGS_H
+#define __SETTINGS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// Сектор 7 (128 КБ) зарезервовано в STM32F401RETX_FLASH.ld
+#define SETTINGS_ADDRESS      0x08060000UL
+#define SETTINGS_SIZE         0x20000UL
+#define SETTINGS_SECTOR       FLASH_SECTOR_7
+
+#define SETTINGS_MAX_KEYS     8
+#define SETTINGS_SAVE_DELAY_MS 2000 // Запис після паузи у змінах
+
+// Ключі збережених параметрів
+#define SETTINGS_KEY_BRIGHTNESS  1
+#define SETTINGS_KEY_LED_STATE   2
+#define SETTINGS_KEY_REPLY_MODE  3
+
+typedef struct {
+    uint32_t records;   // Записів у секторі
+    uint32_t free;      // Вільних записів до стирання
+    uint32_t erases;    // Стирань за час роботи
+    uint32_t corrupted; // Записів з помилкою CRC під час відновлення
+    uint32_t failures;  // Збоїв запису і стирання flash
+} SettingsStats;
+
+void Settings_Init(void);
+uint8_t Settings_Get(uint16_t key, uint32_t *value);
+void Settings_Put(uint16_t key, uint32_t value);
+void Settings_Restore(void);
+void Settings_Poll(void);
+void Settings_GetStats(SettingsStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SETTINGS_H */
@@ -55,6 +55,10 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
+void DMA1_Stream6_IRQHandler(void);
+void USART2_IRQHandler(void);
+void RTC_WKUP_IRQHandler(void);
+void EXTI3_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
@@ -0,0 +1,40 @@
+#ifndef __TIMER_WHEEL_H
+#define __TIMER_WHEEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+#define TIMER_WHEEL_NEVER 0xFFFFFFFFUL // Немає активних таймерів
+
+typedef void (*TimerCallback)(void *context);
+
+// Програмний таймер. Пам'ять виділяє користувач (зазвичай static),
+// колесо лише зв'язує таймери у списки.
+typedef struct Timer {
+    struct Timer *next;
+    struct Timer **pprev;    // Адреса вказівника, що посилається на таймер
+    uint32_t expires;        // Абсолютний час спрацювання, тіки SysTick (мс)
+    uint32_t period;         // 0 - одноразовий таймер
+    TimerCallback callback;  // Викликається з головного циклу, може бути NULL
+    void *context;
+} Timer;
+
+void TimerWheel_InitTimer(Timer *timer, TimerCallback callback, void *context);
+void TimerWheel_Start(Timer *timer, uint32_t delay, uint32_t period);
+void TimerWheel_Stop(Timer *timer);
+uint8_t TimerWheel_IsActive(const Timer *timer);
+void TimerWheel_Tick(void);
+void TimerWheel_Dispatch(void);
+uint8_t TimerWheel_Pending(void);
+void TimerWheel_ExpiredCallback(void);
+uint32_t TimerWheel_NextExpiry(void);
+void TimerWheel_Advance(uint32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMER_WHEEL_H */
@@ -0,0 +1,53 @@
+#ifndef __UART_LINK_H
+#define __UART_LINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+#define UART_LINE_SIZE   100 // Максимальна довжина команди разом з '\0'
+#define UART_LINE_COUNT  4   // Кількість рядкових буферів (конвеєр)
+
+// Ознаки рядка
+#define UART_LINE_OVERFLOW  0x01 // Команда довша за буфер, хвіст відкинуто
+#define UART_LINE_NO_REPLY  0x02 // Груповий кадр шини - відповідь заборонена
+
+// Рядковий буфер: заповнюється в перериванні, обробляється в головному циклі
+typedef struct {
+    uint8_t data[UART_LINE_SIZE];
+    uint16_t length;
+    uint8_t flags;
+} UartLine;
+
+// Лічильники якості лінії USART2
+typedef struct {
+    uint32_t rxBytes;       // Прийнято байтів
+    uint32_t overrun;       // ORE - байт втрачено, приймач не встиг
+    uint32_t framing;       // FE - немає стоп-біта
+    uint32_t noise;         // NE - шум на лінії
+    uint32_t parity;        // PE - помилка парності
+    uint32_t dropped;       // Усі рядкові буфери зайняті, команду втрачено
+    uint32_t rearmFailures; // Не вдалося перезапустити прийом
+    uint32_t txBytes;       // Передано у чергу TX
+    uint32_t txStalls;      // Черга TX була повна, відправник чекав
+} UartLinkStats;
+
+void UartLink_Start(UART_HandleTypeDef *huart);
+UartLine *UartLink_TakeLine(void);
+void UartLink_ReleaseLine(UartLine *line);
+uint8_t UartLink_Pending(void);
+uint8_t UartLink_TxIdle(void);
+uint8_t UartLink_RxIdle(void);
+void UartLink_Write(const uint8_t *data, uint16_t length);
+void UartLink_Put(uint8_t byte);
+void UartLink_Flush(void);
+void UartLink_GetStats(UartLinkStats *stats);
+void UartLink_LineCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_LINK_H */
@@ -0,0 +1,22 @@
+#ifndef __VECTORS_H
+#define __VECTORS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// 16 винятків ядра і переривання STM32F401 до SPI4 включно
+#define VECTORS_COUNT  (16 + SPI4_IRQn + 1)
+
+typedef void (*VectorHandler)(void);
+
+void Vectors_Init(void);
+VectorHandler Vectors_Install(IRQn_Type irq, VectorHandler handler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VECTORS_H */
@@ -0,0 +1,310 @@
+#include "bench.h"
+#include "pt.h"
+#include "hsm.h"
+#include "pool.h"
+#include <stdlib.h>
+#include "kernel.h"
+#include "format.h"
+#if BENCH_NEWLIB_PRINTF
+#include <stdio.h>
+#endif
+#include <strings.h>
+
+// Вимірювання вартості механізмів прошивки в тактах ядра (команда
+// BENCH <назва>). Кожен тест виконує BENCH_ITERATIONS кроків і
+// повертає середню кількість тактів на крок разом із накладними
+// витратами циклу вимірювання.
+
+typedef uint32_t (*BenchFunction)(void);
+
+typedef struct {
+    const char *name;
+    BenchFunction run;
+    uint8_t masked; // 1 - виконується з вимкненими перериваннями
+} BenchEntry;
+
+static volatile uint32_t benchSink; // Не дає компілятору викинути роботу
+
+void Bench_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+// Порожній цикл - базова лінія для інших тестів
+static uint32_t Bench_Empty(void) {
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        benchSink = i;
+    }
+    return Bench_Now() - start;
+}
+
+// Крок автомата станів у стилі lab2: switch по enum, повернення в IDLE
+typedef enum { BENCH_IDLE, BENCH_WORK } BenchState;
+static BenchState benchState = BENCH_IDLE;
+
+static void __attribute__((noinline)) Bench_SwitchStep(void) {
+    switch (benchState) {
+        case BENCH_IDLE:
+            benchState = BENCH_WORK;
+            break;
+        case BENCH_WORK:
+            benchSink++;
+            benchState = BENCH_IDLE;
+            break;
+    }
+}
+
+static uint32_t Bench_Switch(void) {
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        Bench_SwitchStep();
+    }
+    return Bench_Now() - start;
+}
+
+// Той самий цикл, записаний протопотоком: одне перемикання за крок
+static Pt benchPt;
+
+static int __attribute__((noinline)) Bench_PtStep(Pt *pt) {
+    PT_BEGIN(pt);
+    while (1) {
+        PT_YIELD(pt);
+        benchSink++;
+    }
+    PT_END(pt);
+}
+
+static uint32_t Bench_Protothread(void) {
+    PT_INIT(&benchPt);
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        Bench_PtStep(&benchPt);
+    }
+    return Bench_Now() - start;
+}
+
+// Ієрархічний автомат: два листові стани в спільному батьку. HSM -
+// лише пошук у таблиці і внутрішня дія, HSMT - ще й вихід з одного
+// листа та вхід в інший через спільного предка.
+enum { BENCH_HSM_TOP, BENCH_HSM_A, BENCH_HSM_B };
+enum { BENCH_EVENT_COUNT = 1, BENCH_EVENT_TOGGLE };
+
+static void Bench_HsmAction(Hsm *hsm, const Event *event) {
+    (void)hsm;
+    (void)event;
+    benchSink++;
+}
+
+static const HsmTransition benchTopTransitions[] = {
+    { BENCH_EVENT_COUNT, HSM_INTERNAL, Bench_HsmAction },
+};
+static const HsmTransition benchATransitions[] = {
+    { BENCH_EVENT_TOGGLE, BENCH_HSM_B, NULL },
+};
+static const HsmTransition benchBTransitions[] = {
+    { BENCH_EVENT_TOGGLE, BENCH_HSM_A, NULL },
+};
+
+static const HsmState benchHsmStates[] = {
+    [BENCH_HSM_TOP] = { "top", HSM_NONE, BENCH_HSM_A, NULL, NULL, HSM_TRANSITIONS(benchTopTransitions) },
+    [BENCH_HSM_A] = { "a", BENCH_HSM_TOP, HSM_NONE, Bench_HsmAction, Bench_HsmAction, HSM_TRANSITIONS(benchATransitions) },
+    [BENCH_HSM_B] = { "b", BENCH_HSM_TOP, HSM_NONE, Bench_HsmAction, Bench_HsmAction, HSM_TRANSITIONS(benchBTransitions) },
+};
+
+static Hsm benchHsm;
+
+static uint32_t Bench_HsmRun(uint16_t type) {
+    const Event event = { .type = type };
+
+    Hsm_Init(&benchHsm, benchHsmStates, sizeof(benchHsmStates) / sizeof(benchHsmStates[0]), NULL);
+    Hsm_Start(&benchHsm);
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        Hsm_Dispatch(&benchHsm, &event);
+    }
+    return Bench_Now() - start;
+}
+
+static uint32_t Bench_Hsm(void) {
+    return Bench_HsmRun(BENCH_EVENT_COUNT);
+}
+
+static uint32_t Bench_HsmTransition(void) {
+    return Bench_HsmRun(BENCH_EVENT_TOGGLE);
+}
+
+// Пара виділення і звільнення: пул напряму і malloc (класи розмірів
+// поверх тих самих пулів)
+POOL_DEFINE(benchPool, 32, 4);
+
+static uint32_t Bench_Pool(void) {
+    static uint8_t ready = 0;
+    if (!ready) {
+        Pool_Init(&benchPool);
+        ready = 1;
+    }
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        void *block = Pool_Alloc(&benchPool);
+        benchSink = (uint32_t)block;
+        Pool_Free(&benchPool, block);
+    }
+    return Bench_Now() - start;
+}
+
+static uint32_t Bench_Malloc(void) {
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        void *block = malloc(48);
+        benchSink = (uint32_t)block;
+        free(block);
+    }
+    return Bench_Now() - start;
+}
+
+// Типовий рядок статистики: кілька чисел, ширина з нулями, шістнадцяткове
+#define BENCH_FORMAT "RX=%lu DROP=%lu MAX=%5lu A%u %08lX\r\n"
+#define BENCH_FORMAT_ARGS(i) (i), (i) >> 3, (i) * 7, (unsigned)(i), (i) * 0x9E3779B1u
+
+static uint32_t Bench_Format(void) {
+    char buffer[48];
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        benchSink = Format_Buffer(buffer, sizeof(buffer), BENCH_FORMAT, BENCH_FORMAT_ARGS(i));
+    }
+    return Bench_Now() - start;
+}
+
+// Код у flash проти коду в SRAM за найгіршого випадку: перед кожним
+// викликом кеші ART скидаються, як після довгої роботи іншого коду.
+// Рахуються лише такти самого виклику, разом з поверненням у flash.
+static inline __attribute__((always_inline)) uint32_t Bench_ColdWork(uint32_t value) {
+    for (uint32_t i = 0; i < 8; i++) {
+        value = (value & 1) ? (value >> 1) ^ 0xEDB88320 : value >> 1;
+    }
+    return value;
+}
+
+static __attribute__((noinline)) uint32_t Bench_ColdFlashWork(uint32_t value) {
+    return Bench_ColdWork(value);
+}
+
+static __attribute__((noinline)) __RAM_FUNC uint32_t Bench_ColdRamWork(uint32_t value) {
+    return Bench_ColdWork(value);
+}
+
+static uint32_t Bench_Cold(uint32_t (*work)(uint32_t)) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+        __HAL_FLASH_DATA_CACHE_DISABLE();
+        __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+        __HAL_FLASH_DATA_CACHE_RESET();
+        __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+        __HAL_FLASH_DATA_CACHE_ENABLE();
+        uint32_t start = Bench_Now();
+        benchSink = work(i);
+        total += Bench_Now() - start;
+    }
+    return total;
+}
+
+static uint32_t Bench_ColdFlash(void) {
+    return Bench_Cold(Bench_ColdFlashWork);
+}
+
+static uint32_t Bench_ColdRam(void) {
+    return Bench_Cold(Bench_ColdRamWork);
+}
+
+#if BENCH_NEWLIB_PRINTF
+// Те саме через snprintf newlib для порівняння; за замовчуванням вимкнено,
+// щоб форматування newlib не потрапляло в образ
+static uint32_t Bench_Snprintf(void) {
+    char buffer[48];
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        benchSink = snprintf(buffer, sizeof(buffer), BENCH_FORMAT, BENCH_FORMAT_ARGS(i));
+    }
+    return Bench_Now() - start;
+}
+#endif
+
+#if KERNEL_ENABLED
+// Перемикання контексту ядра: задача з найвищим пріоритетом відповідає
+// на кожен семафор, тож один крок - два перемикання. Потрібні
+// переривання (PendSV), тому тест іде без маскування.
+#define BENCH_TASK_STACK 128
+
+static KernelTask benchTask;
+static uint32_t benchStack[BENCH_TASK_STACK] __ALIGNED(8);
+static KernelSemaphore benchPing;
+static KernelSemaphore benchPong;
+
+static void Bench_PongTask(void *argument) {
+    (void)argument;
+    while (1) {
+        Kernel_SemTake(&benchPing, KERNEL_WAIT_FOREVER);
+        Kernel_SemGive(&benchPong);
+    }
+}
+
+static uint32_t Bench_Context(void) {
+    static uint8_t started = 0;
+
+    if (!Kernel_IsRunning()) {
+        return 0;
+    }
+    if (!started) {
+        Kernel_SemInit(&benchPing, 0, 1);
+        Kernel_SemInit(&benchPong, 0, 1);
+        Kernel_CreateTask(&benchTask, "bench", Bench_PongTask, NULL,
+                          benchStack, BENCH_TASK_STACK, KERNEL_PRIORITIES - 1);
+        started = 1;
+    }
+    uint32_t start = Bench_Now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        Kernel_SemGive(&benchPing); // Тут - перемикання на Bench_PongTask і назад
+        Kernel_SemTake(&benchPong, KERNEL_WAIT_FOREVER);
+    }
+    return Bench_Now() - start;
+}
+#endif
+
+static const BenchEntry benchTable[] = {
+    { "EMPTY",  Bench_Empty,         1 },
+    { "SWITCH", Bench_Switch,        1 },
+    { "PT",     Bench_Protothread,   1 },
+    { "HSM",    Bench_Hsm,           1 },
+    { "HSMT",   Bench_HsmTransition, 1 },
+    { "POOL",   Bench_Pool,          1 },
+    { "MALLOC", Bench_Malloc,        1 },
+    { "FMT",    Bench_Format,        1 },
+    { "FLASH",  Bench_ColdFlash,     1 },
+    { "SRAM",   Bench_ColdRam,       1 },
+#if BENCH_NEWLIB_PRINTF
+    { "SNPRINTF", Bench_Snprintf,    1 },
+#endif
+#if KERNEL_ENABLED
+    { "CTX",    Bench_Context,       0 },
+#endif
+};
+
+uint8_t Bench_Run(const char *name, char *response, uint16_t size) {
+    for (uint32_t i = 0; i < sizeof(benchTable) / sizeof(benchTable[0]); i++) {
+        if (strcasecmp(name, benchTable[i].name) == 0) {
+            uint32_t primask = __get_PRIMASK();
+            if (benchTable[i].masked) {
+                __disable_irq(); // Переривання спотворили б вимірювання
+            }
+            uint32_t cycles = benchTable[i].run();
+            __set_PRIMASK(primask);
+            Format_Buffer(response, size, "%s: %lu cycles/step\r\n",
+                          benchTable[i].name, (cycles + BENCH_ITERATIONS / 2) / BENCH_ITERATIONS);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "boot.h"
+#include "bench.h"
+#include "retain.h"
+
+// Профіль завантаження: мітка DWT CYCCNT після кожного етапу ініціалізації
+// (команда BOOT). Лічильник запускає Reset_Handler, тож перші етапи -
+// запуск PLL і ініціалізація RAM до main(). Частота ядра під час
+// завантаження змінюється (HSI 16 МГц до PLL), тож такти етапу
+// переводяться в мікросекунди за частотою на його початку. Похибка - до
+// 1 мкс на етап.
+
+static BootStage stages[BOOT_MAX_STAGES];
+static uint8_t stageCount = 0;
+static uint32_t lastCycles = 0; // CYCCNT попередньої мітки
+static uint32_t lastMhz;        // Частота ядра після попередньої мітки
+static uint32_t elapsedUs = 0;
+// Такти від скидання до перемикання на PLL. Пишеться до ініціалізації
+// RAM, тому лише в .noinit: .data і .bss startup потім перезаписує
+static RETAIN_NOINIT uint32_t clockCycles;
+
+// PLL 84 МГц з Reset_Handler, до копіювання .data і обнулення .bss:
+// решта ініціалізації RAM іде вп'ятеро швидше. Лише регістри, жодних
+// змінних, крім .noinit; SystemCoreClock оновлює startup після
+// копіювання .data. PLL і дільники ті самі, що в SystemClock_Config,
+// тож HAL потім лише перевіряє вже активну конфігурацію.
+void Boot_ClockInit(void) {
+    FLASH->ACR = FLASH_ACR_ICEN | FLASH_ACR_DCEN | FLASH_ACR_PRFTEN | FLASH_ACR_LATENCY_2WS;
+    while ((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_2WS) {
+    }
+    MODIFY_REG(RCC->PLLCFGR,
+               RCC_PLLCFGR_PLLSRC | RCC_PLLCFGR_PLLM | RCC_PLLCFGR_PLLN |
+               RCC_PLLCFGR_PLLP | RCC_PLLCFGR_PLLQ,
+               RCC_PLLCFGR_PLLSRC_HSI | (16 << RCC_PLLCFGR_PLLM_Pos) |
+               (336 << RCC_PLLCFGR_PLLN_Pos) | (((4 >> 1) - 1) << RCC_PLLCFGR_PLLP_Pos) |
+               (7 << RCC_PLLCFGR_PLLQ_Pos));
+    RCC->CR |= RCC_CR_PLLON;
+    while (!(RCC->CR & RCC_CR_PLLRDY)) {
+    }
+    // Дільники APB - до перемикання, щоб PCLK1 не перевищила 42 МГц
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2,
+               RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2);
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+    }
+    clockCycles = DWT->CYCCNT;
+}
+
+static void Boot_Record(const char *name, uint32_t now) {
+    elapsedUs += (now - lastCycles) / lastMhz;
+    lastCycles = now;
+    lastMhz = SystemCoreClock / 1000000;
+    if (stageCount < BOOT_MAX_STAGES) {
+        stages[stageCount].name = name;
+        stages[stageCount].us = elapsedUs;
+        stageCount++;
+    }
+}
+
+// Перший виклик main(): етапи до main() (лічильник запущено на HSI у
+// Reset_Handler) і лічильник тактів для BENCH
+void Boot_Start(void) {
+    uint32_t now = Bench_Now();
+
+    lastMhz = HSI_VALUE / 1000000;
+    Boot_Record("pll", clockCycles);
+    Boot_Record("startup", now);
+    Bench_Init();
+    lastCycles = Bench_Now();
+}
+
+// Кінець етапу; назва має жити весь час роботи (рядковий літерал)
+void Boot_Mark(const char *name) {
+    Boot_Record(name, Bench_Now());
+}
+
+uint8_t Boot_Count(void) {
+    return stageCount;
+}
+
+const BootStage *Boot_Stage(uint8_t index) {
+    return index < stageCount ? &stages[index] : NULL;
+}
@@ -0,0 +1,48 @@
+#include "bus.h"
+
+// Вузол "спить" в апаратному mute-режимі USART: поки на лінії йдуть кадри
+// інших груп, RXNE не встановлюється і процесор не отримує жодного байта.
+// Адресний байт своєї групи будить приймач, далі номер вузла перевіряється
+// програмно - чужий кадр одразу повертає приймач у mute.
+
+static UART_HandleTypeDef *busUart = NULL;
+
+// Перехід у mute без зміни gState, щоб не зачепити передачу, що триває
+static void Bus_Mute(void) {
+    ATOMIC_SET_BIT(busUart->Instance->CR1, USART_CR1_RWU);
+}
+
+void Bus_Init(UART_HandleTypeDef *huart) {
+#if BUS_MODE_ENABLED
+    busUart = huart;
+    Bus_Mute();
+#else
+    (void)huart;
+#endif
+}
+
+uint8_t Bus_IsAddressByte(uint8_t data) {
+    return (busUart != NULL) && (data & BUS_ADDRESS_MARK);
+}
+
+// Викликається з переривання прийому для кожного адресного байта.
+// На груповий кадр вузли не відповідають, щоб не було колізій на лінії TX.
+uint8_t Bus_SelectFrame(uint8_t address) {
+    uint8_t unit = (address >> 4) & 0x7;
+
+    if (unit == BUS_UNIT_ALL) {
+        return BUS_FRAME_GROUP;
+    }
+    if (unit == BUS_UNIT_ADDRESS) {
+        return BUS_FRAME_UNIT;
+    }
+    // Кадр сусіда по групі - спимо до наступного адресного байта
+    Bus_Mute();
+    return BUS_FRAME_NONE;
+}
+
+void Bus_EndFrame(void) {
+    if (busUart != NULL) {
+        Bus_Mute();
+    }
+}
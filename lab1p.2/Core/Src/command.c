@@ -0,0 +1,155 @@
+#include "command.h"
+#include "reply.h"
+#include "effect.h"
+#include "bench.h"
+#include "kernel.h"
+#include "power.h"
+#include "deferred.h"
+#include "isr_monitor.h"
+#include "settings.h"
+#include "memory.h"
+#include "pool.h"
+#include "boot.h"
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <ctype.h>
+
+// Обробка команд UART, спільна для обох варіантів прошивки
+
+// Розбір значення "X=<n>" у межах [min, max]
+static uint8_t Command_ParseValue(const char *text, int min, int max, int *value) {
+    *value = -1;
+    return sscanf(text, "%d", value) == 1 && *value >= min && *value <= max;
+}
+
+HOT_FUNC void Command_Execute(const UartLine *line) {
+    const char *command = (const char *)line->data;
+    char response[100]; // Буфер для результату BENCH
+    int value;
+
+    if (line->flags & UART_LINE_OVERFLOW) {
+        // Якщо команда занадто довга
+        Reply_Result(line, REPLY_TOO_LONG, "Error: Command too long\r\n");
+    } else if (tolower((unsigned char)command[0]) == 'l' && command[1] == '=') {
+        // Зчитування нового значення яскравості
+        if (Command_ParseValue(&command[2], 0, 99, &value)) {
+            Effect_Stop();      // Нова уставка скасовує ефект
+            brightness = value; // Оновлення яскравості
+            if (ledState) {
+                // Застосування нової яскравості, якщо світлодіод увімкнено
+                __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, brightness * 10);
+            }
+            Reply_ResultFormat(line, REPLY_OK, "Brightness set to %d\r\n", brightness);
+        } else {
+            // Якщо значення некоректне
+            Reply_Result(line, REPLY_INVALID_VALUE, "Error: Invalid value\r\n");
+        }
+    } else if (tolower((unsigned char)command[0]) == 'f' && command[1] == '=') {
+        // Плавна зміна яскравості: F=<рівень>,<тривалість, мс>
+        int duration = -1;
+        if (sscanf(&command[2], "%d,%d", &value, &duration) == 2 &&
+            value >= 0 && value <= 99 && duration >= 0 && duration <= EFFECT_MAX_MS) {
+            Effect_StartFade(value, duration);
+            Reply_ResultFormat(line, REPLY_OK, "Fade to %d in %d ms\r\n", value, duration);
+        } else {
+            Reply_Result(line, REPLY_INVALID_VALUE, "Error: Invalid value\r\n");
+        }
+    } else if (tolower((unsigned char)command[0]) == 'v' && command[1] == '=') {
+        // Режим відповідей: 0 - тихий, 1 - коди, 2 - повний текст
+        if (Command_ParseValue(&command[2], REPLY_SILENT, REPLY_VERBOSE, &value)) {
+            Reply_SetMode(value);
+            Reply_ResultFormat(line, REPLY_OK, "Reply mode set to %d\r\n", value);
+        } else {
+            Reply_Result(line, REPLY_INVALID_VALUE, "Error: Invalid value\r\n");
+        }
+    } else if (strcasecmp(command, "STATS") == 0) {
+        // Лічильники помилок лінії UART
+        UartLinkStats stats;
+        UartLink_GetStats(&stats);
+        Reply_Format(line, "RX=%lu ORE=%lu FE=%lu NE=%lu PE=%lu DROP=%lu REARM=%lu TX=%lu TXWAIT=%lu\r\n",
+                     stats.rxBytes, stats.overrun, stats.framing, stats.noise,
+                     stats.parity, stats.dropped, stats.rearmFailures,
+                     stats.txBytes, stats.txStalls);
+    } else if (strcasecmp(command, "DEFER") == 0) {
+        // Нижні половини: кількість, втрати, зайнятість PendSV і затримка, такти
+        DeferredStats stats;
+        Deferred_GetStats(&stats);
+        Reply_Format(line, "BH=%lu DROP=%lu BUSY=%lu MAX=%lu LAT=%lu\r\n",
+                     stats.items, stats.dropped, stats.busyCycles, stats.maxCycles, stats.maxLatency);
+    } else if (strcasecmp(command, "POWER") == 0) {
+        // Сон без SysTick, STOP, час відновлення тактування і поточна частота
+        PowerStats stats;
+        Power_GetStats(&stats);
+        Reply_Format(line, "SLEEP=%lu STOP=%lu WAKE=%luus MAXWAKE=%luus MHZ=%lu\r\n",
+                     stats.sleeps, stats.stops, stats.lastWakeUs, stats.maxWakeUs,
+                     SystemCoreClock / 1000000);
+    } else if (strcasecmp(command, "SETTINGS") == 0) {
+        // Журнал параметрів у flash: записів, вільно до стирання, стирань,
+        // збоїв CRC, збоїв запису/стирання
+        SettingsStats stats;
+        Settings_GetStats(&stats);
+        Reply_Format(line, "REC=%lu FREE=%lu ERASE=%lu BAD=%lu FAIL=%lu\r\n",
+                     stats.records, stats.free, stats.erases, stats.corrupted, stats.failures);
+    } else if (strcasecmp(command, "MEM") == 0) {
+        // Пікова глибина стека / резерв, купа (пік і зараз), незаймана RAM, байти
+        MemoryStats stats;
+        Memory_GetStats(&stats);
+        Reply_Format(line, "STACK=%lu/%lu HEAP=%lu USED=%lu FREE=%lu SBRKFAIL=%lu\r\n",
+                     stats.stackPeak, stats.stackReserved, stats.heapPeak, stats.heapInUse,
+                     stats.freeRam, stats.heapFailures);
+    } else if (strcasecmp(command, "POOL") == 0) {
+        // Пули блоків: розмір блоку, зайнято/усього, пік, відмови
+        for (const Pool *pool = Pool_First(); pool != NULL; pool = pool->nextPool) {
+            Reply_Format(line, "%s %ux%u USED=%u PEAK=%u FAIL=%lu\r\n",
+                         pool->name, pool->blockSize, pool->blockCount,
+                         pool->used, pool->peak, pool->failures);
+        }
+    } else if (strcasecmp(command, "ISR") == 0) {
+        // Завантаження перериваннями і гістограми на кожне переривання:
+        // D - власний час, L - затримка входу (лише TICK), кошики по x4
+        // тактів від 64; рядки пишуться в чергу TX частинами, без буфера
+        IsrMonitorStats stats;
+        uint16_t load = IsrMonitor_Load();
+        Reply_Format(line, "LOAD=%u.%u%%\r\n", load / 10, load % 10);
+        for (uint32_t irq = 0; irq < ISR_MONITOR_COUNT; irq++) {
+            IsrMonitor_GetStats(irq, &stats);
+            Reply_Format(line, "%s N=%lu MAX=%lu D=", IsrMonitor_Name(irq), stats.count, stats.maxDuration);
+            for (uint32_t i = 0; i < ISR_MONITOR_BUCKETS; i++) {
+                Reply_Format(line, i ? ",%lu" : "%lu", stats.duration[i]);
+            }
+            if (irq == ISR_MONITOR_TICK) {
+                Reply_Format(line, " LATMAX=%lu L=", stats.maxLatency);
+                for (uint32_t i = 0; i < ISR_MONITOR_BUCKETS; i++) {
+                    Reply_Format(line, i ? ",%lu" : "%lu", stats.latency[i]);
+                }
+            }
+            Reply_Text(line, "\r\n");
+        }
+    } else if (strcasecmp(command, "BOOT") == 0) {
+        // Профіль завантаження: мкс від скидання до кінця кожного етапу
+        for (uint8_t i = 0; i < Boot_Count(); i++) {
+            const BootStage *stage = Boot_Stage(i);
+            Reply_Format(line, i ? " %s=%lu" : "%s=%lu", stage->name, stage->us);
+        }
+        Reply_Text(line, "us\r\n");
+#if KERNEL_ENABLED
+    } else if (strcasecmp(command, "KERNEL") == 0) {
+        // Стан ядра: завантаження, перемикання, найдовша критична секція
+        KernelStats stats;
+        Kernel_GetStats(&stats);
+        Reply_Format(line, "LOAD=%u%% SW=%lu LOCK=%lu\r\n",
+                     stats.load, stats.switches, stats.maxLockCycles);
+#endif
+    } else if (strncasecmp(command, "BENCH ", 6) == 0) {
+        // Вимірювання тактів: BENCH <назва тесту>
+        if (Bench_Run(&command[6], response, sizeof(response))) {
+            Reply_Text(line, response);
+        } else {
+            Reply_Result(line, REPLY_INVALID_VALUE, "Error: Invalid value\r\n");
+        }
+    } else {
+        // Якщо команда некоректна
+        Reply_Result(line, REPLY_INVALID_COMMAND, "Error: Invalid command\r\n");
+    }
+}
@@ -0,0 +1,81 @@
+#include "deferred.h"
+
+// Нижні половини переривань. Обробник переривання лише фіксує дані
+// (Deferred_Post) і ставить у чергу PendSV з найнижчим пріоритетом;
+// PendSV виконує накопичену роботу, коли завершаться всі інші
+// обробники, тож прикладна робота не затримує жодне переривання.
+// У кожного джерела власна черга з одним записувачем, тому запис не
+// потребує блокувань. З ядром (KERNEL_ENABLED) PendSV_Handler у
+// kernel.c спершу викликає Deferred_Drain, а потім перемикає задачі.
+
+static DeferredQueue *queues[DEFERRED_MAX_QUEUES]; // За спаданням пріоритету
+static uint8_t queueCount = 0;
+static volatile DeferredStats deferredStats;
+
+void Deferred_Init(void) {
+    NVIC_SetPriority(PendSV_IRQn, IRQ_PRIORITY_DEFERRED);
+}
+
+// Реєстрація джерела; викликається до ввімкнення його переривання
+void Deferred_Register(DeferredQueue *queue, uint8_t priority) {
+    uint8_t i = queueCount;
+
+    if (queueCount >= DEFERRED_MAX_QUEUES) {
+        Error_Handler();
+    }
+    queue->priority = priority;
+    while (i > 0 && queues[i - 1]->priority < priority) {
+        queues[i] = queues[i - 1];
+        i--;
+    }
+    queues[i] = queue;
+    queueCount++;
+}
+
+// З переривання: 0 - черга повна, подію враховано як втрачену
+HOT_FUNC uint8_t Deferred_Post(DeferredQueue *queue, uint32_t data) {
+    uint8_t head = queue->head;
+    uint8_t next = (head + 1) & (DEFERRED_QUEUE_SIZE - 1);
+
+    if (next == queue->tail) {
+        deferredStats.dropped++;
+        return 0;
+    }
+    queue->data[head] = data;
+    queue->posted[head] = DWT->CYCCNT;
+    queue->head = next;
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    return 1;
+}
+
+// Виконання всіх накопичених нижніх половин; лише з PendSV
+void Deferred_Drain(void) {
+    uint32_t start = DWT->CYCCNT;
+
+    for (uint8_t i = 0; i < queueCount; i++) {
+        DeferredQueue *queue = queues[i];
+        uint8_t tail = queue->tail;
+        while (tail != queue->head) {
+            uint32_t latency = DWT->CYCCNT - queue->posted[tail];
+            if (latency > deferredStats.maxLatency) {
+                deferredStats.maxLatency = latency;
+            }
+            queue->handler(queue->data[tail]);
+            tail = (tail + 1) & (DEFERRED_QUEUE_SIZE - 1);
+            queue->tail = tail;
+            deferredStats.items++;
+        }
+    }
+
+    uint32_t cycles = DWT->CYCCNT - start;
+    deferredStats.busyCycles += cycles;
+    if (cycles > deferredStats.maxCycles) {
+        deferredStats.maxCycles = cycles;
+    }
+}
+
+void Deferred_GetStats(DeferredStats *stats) {
+    __disable_irq();
+    *stats = *(const DeferredStats *)&deferredStats;
+    __enable_irq();
+}
@@ -0,0 +1,128 @@
+#include "dvfs.h"
+#include "timer_wheel.h"
+#include "uart_link.h"
+#include "effect.h"
+
+// Динамічна зміна частоти. Уся робота - ШІМ і UART на 9600 бод - не
+// потребує 84 МГц, тому після DVFS_HOLD_MS без команд SYSCLK
+// переходить на HSI 16 МГц, PLL вимикається, і стабілізатор сам
+// опускається в Scale 3. Прийнятий рядок повертає PLL (Scale 2, 84 МГц).
+//
+// Разом із SYSCLK перераховуються всі похідні частоти: BRR USART2,
+// PSC TIM2 (CNT зберігається, тож період ШІМ не збивається) і SysTick.
+// Перемикання виконується одразу після перезавантаження SysTick,
+// тому HAL_GetTick відстає щонайбільше на кілька мікросекунд.
+// Частота знижується лише тоді, коли черга TX порожня. Приймач має
+// мовчати в обидва боки: байт, що приймається під час зміни BRR,
+// дочитується з іншою швидкістю і псується. Тому перемикання
+// відкладається на DVFS_RETRY_MS, доки лінія RX не простоїть кадр.
+
+static void Dvfs_HoldExpired(void *context);
+static Timer holdTimer = { .callback = Dvfs_HoldExpired };
+static uint8_t dvfsHigh = 1;
+
+// Нові дільники для поточного SYSCLK; викликається з вимкненими перериваннями
+static void Dvfs_Rescale(void) {
+    SystemCoreClock = HAL_RCC_GetSysClockFreq(); // AHB без дільника
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    // Таймери APB1 тактуються подвоєною PCLK1, якщо дільник APB1 не 1
+    uint32_t timerClock = (RCC->CFGR & RCC_CFGR_PPRE1_2) ? pclk1 * 2 : pclk1;
+
+    // PSC буферизований: UG застосовує його одразу, CNT відновлюється
+    uint32_t count = TIM2->CNT;
+    TIM2->PSC = timerClock / DVFS_TIM2_HZ - 1;
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->CNT = count;
+
+    USART2->BRR = UART_BRR_SAMPLING16(pclk1, huart2.Init.BaudRate);
+
+    SysTick->LOAD = SystemCoreClock / 1000 - 1;
+    SysTick->VAL = 0;
+}
+
+// Чекає, поки SysTick щойно перезавантажиться, і вимикає переривання
+static uint32_t Dvfs_LockAtTick(void) {
+    (void)SysTick->CTRL; // Читання скидає COUNTFLAG
+    while (!(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)) {
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+// 0 - приймач зайнятий, частота не змінена
+static uint8_t Dvfs_Switch(uint32_t source, uint32_t status) {
+    uint32_t primask = Dvfs_LockAtTick();
+    if (!UartLink_RxIdle()) {
+        __set_PRIMASK(primask);
+        return 0;
+    }
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, source);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != status) {
+    }
+    Dvfs_Rescale();
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+static uint8_t Dvfs_Lower(void) {
+    if (!Dvfs_Switch(RCC_CFGR_SW_HSI, RCC_CFGR_SWS_HSI)) {
+        return 0;
+    }
+    __HAL_FLASH_SET_LATENCY(FLASH_LATENCY_0);
+    __HAL_RCC_PLL_DISABLE(); // Без PLL стабілізатор переходить у Scale 3
+    dvfsHigh = 0;
+    return 1;
+}
+
+static uint8_t Dvfs_Raise(void) {
+    // Scale 2 стає активним разом із PLL; функція сама вмикає PLL.
+    // Якщо перемикання відкладено, PLL і затримка flash так і лишаються
+    if (HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE2) != HAL_OK) {
+        return 0;
+    }
+    __HAL_FLASH_SET_LATENCY(FLASH_LATENCY_2);
+    if (!Dvfs_Switch(RCC_CFGR_SW_PLL, RCC_CFGR_SWS_PLL)) {
+        return 0;
+    }
+    dvfsHigh = 1;
+    return 1;
+}
+
+// Кінець утримання або повтор відкладеного підвищення
+static void Dvfs_HoldExpired(void *context) {
+    (void)context;
+    if (!dvfsHigh) {
+        Dvfs_Boost();
+        return;
+    }
+    if (!UartLink_TxIdle() || Effect_IsRunning()) {
+        TimerWheel_Start(&holdTimer, DVFS_HOLD_MS, 0); // Ще зайняті
+        return;
+    }
+    if (!Dvfs_Lower()) {
+        TimerWheel_Start(&holdTimer, DVFS_RETRY_MS, 0); // Триває прийом
+    }
+}
+
+void Dvfs_Init(void) {
+    if (DVFS_ENABLED && !KERNEL_ENABLED) {
+        TimerWheel_Start(&holdTimer, DVFS_HOLD_MS, 0);
+    }
+}
+
+// Активність: повна частота щонайменше на DVFS_HOLD_MS
+void Dvfs_Boost(void) {
+    if (!DVFS_ENABLED || KERNEL_ENABLED) {
+        return;
+    }
+    if (!dvfsHigh && !Dvfs_Raise()) {
+        TimerWheel_Start(&holdTimer, DVFS_RETRY_MS, 0); // Триває прийом
+        return;
+    }
+    TimerWheel_Start(&holdTimer, DVFS_HOLD_MS, 0);
+}
+
+uint8_t Dvfs_IsHigh(void) {
+    return dvfsHigh;
+}
@@ -0,0 +1,82 @@
+#include "effect.h"
+#include "timer_wheel.h"
+#include "retain.h"
+
+// Плавна зміна яскравості: періодичний таймер колеса кожні EFFECT_STEP_MS
+// обчислює проміжне значення, головний цикл при цьому не чекає
+
+static void Effect_Step(void *context);
+static Timer effectTimer = { .callback = Effect_Step };
+// Стан ефекту переживає скидання (Effect_Resume); після холодного
+// старту він невизначений, але до Effect_StartFade не читається
+static RETAIN_NOINIT uint8_t fadeStart;     // Яскравість на початку ефекту
+static RETAIN_NOINIT uint8_t fadeTarget;    // Кінцева яскравість
+static RETAIN_NOINIT uint16_t fadeSteps;    // Кількість кроків ефекту, 0 - скасовано
+static RETAIN_NOINIT uint16_t fadePosition; // Поточний крок
+
+static void Effect_Apply(uint8_t level) {
+    brightness = level;
+    if (ledState) {
+        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, brightness * 10);
+    }
+}
+
+static uint8_t Effect_Level(void) {
+    int32_t delta = (int32_t)fadeTarget - fadeStart;
+    return fadeStart + delta * fadePosition / fadeSteps;
+}
+
+static void Effect_Step(void *context) {
+    (void)context;
+    fadePosition++;
+    Effect_Apply(Effect_Level());
+    if (fadePosition >= fadeSteps) {
+        TimerWheel_Stop(&effectTimer);
+        Effect_DoneCallback();
+    }
+}
+
+void Effect_StartFade(uint8_t target, uint32_t durationMs) {
+    fadeStart = brightness;
+    fadeTarget = target;
+    fadeSteps = durationMs / EFFECT_STEP_MS;
+    fadePosition = 0;
+    if (fadeSteps == 0) {
+        TimerWheel_Stop(&effectTimer);
+        Effect_Apply(target);
+        Effect_DoneCallback();
+        return;
+    }
+    TimerWheel_Start(&effectTimer, EFFECT_STEP_MS, EFFECT_STEP_MS);
+}
+
+void Effect_Stop(void) {
+    TimerWheel_Stop(&effectTimer);
+    fadeSteps = 0;
+}
+
+// Продовження ефекту, перерваного теплим скиданням
+void Effect_Resume(void) {
+    if (fadeSteps == 0 || fadePosition >= fadeSteps || fadeSteps > EFFECT_MAX_MS / EFFECT_STEP_MS ||
+        fadeStart > 99 || fadeTarget > 99) {
+        fadeSteps = 0;
+        return;
+    }
+    Effect_Apply(Effect_Level());
+    TimerWheel_Start(&effectTimer, EFFECT_STEP_MS, EFFECT_STEP_MS);
+}
+
+uint8_t Effect_IsRunning(void) {
+    return TimerWheel_IsActive(&effectTimer);
+}
+
+// Яскравість, на якій ефект зупиниться: поки він триває - кінцева,
+// інакше поточна. Зберігати слід її, а не проміжне значення
+uint8_t Effect_Target(void) {
+    return Effect_IsRunning() ? fadeTarget : brightness;
+}
+
+// Ефект досяг кінцевої яскравості (не викликається після Effect_Stop).
+// Викликається з головного циклу; застосунок може перевизначити.
+__weak void Effect_DoneCallback(void) {
+}
@@ -0,0 +1,83 @@
+#include "event_queue.h"
+
+// Черга подій без блокувань. Кожен слот має номер позиції: слот вільний
+// для запису позиції pos, коли sequence == pos, і готовий до читання,
+// коли sequence == pos + 1. Записувач захоплює позицію, збільшуючи
+// head через LDREX/STREX: якщо між ними встигло спрацювати інше
+// переривання, монітор ексклюзивного доступу скидається на вході у
+// виняток, STREX не проходить, і спроба повторюється з новим head.
+// Захоплений слот заповнюється і лише потім публікується записом
+// sequence, тож споживач ніколи не бачить половину події.
+// Різниця sequence - pos зі знаком: менше нуля - слот ще зайнятий
+// попереднім колом (черга повна), більше нуля - позицію вже забрали.
+// Переповнення не затирає старі події, а рахується в dropped.
+
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_SIZE - 1)
+
+void EventQueue_Init(EventQueue *queue) {
+    for (uint32_t i = 0; i < EVENT_QUEUE_SIZE; i++) {
+        queue->slots[i].sequence = i;
+    }
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+static void EventQueue_CountDrop(EventQueue *queue) {
+    uint32_t dropped;
+    do {
+        dropped = __LDREXW(&queue->dropped);
+    } while (__STREXW(dropped + 1, &queue->dropped));
+}
+
+// З переривання будь-якого пріоритету або з головного циклу
+uint8_t EventQueue_Post(EventQueue *queue, uint16_t type, uint16_t arg, uint32_t data) {
+    uint32_t position;
+    EventSlot *slot;
+
+    for (;;) {
+        position = __LDREXW(&queue->head);
+        slot = &queue->slots[position & EVENT_QUEUE_MASK];
+        int32_t lag = (int32_t)(slot->sequence - position);
+        if (lag == 0) {
+            if (__STREXW(position + 1, &queue->head) == 0) {
+                break;
+            }
+        } else if (lag < 0) {
+            // Слот ще з попереднього кола не прочитано - черга повна
+            __CLREX();
+            EventQueue_CountDrop(queue);
+            return 0;
+        } else {
+            // Переривання вищого пріоритету вже захопило цю позицію
+            // між LDREX і читанням sequence - head застарів, повтор
+            __CLREX();
+        }
+    }
+
+    slot->event.type = type;
+    slot->event.arg = arg;
+    slot->event.data = data;
+    __DMB();
+    slot->sequence = position + 1; // Публікація
+    return 1;
+}
+
+// Лише споживач. 0 - подій немає (або наступна ще не опублікована)
+uint8_t EventQueue_Take(EventQueue *queue, Event *event) {
+    EventSlot *slot = &queue->slots[queue->tail & EVENT_QUEUE_MASK];
+
+    if (slot->sequence != queue->tail + 1) {
+        return 0;
+    }
+    __DMB();
+    *event = slot->event;
+    __DMB();
+    slot->sequence = queue->tail + EVENT_QUEUE_SIZE; // Вільний для наступного кола
+    queue->tail++;
+    return 1;
+}
+
+uint32_t EventQueue_Dropped(const EventQueue *queue) {
+    return queue->dropped;
+}
@@ -0,0 +1,163 @@
+#include "format.h"
+
+// Невеликий форматувальник замість snprintf newlib: лише цілі й рядки,
+// без плаваючої коми, локалей і malloc. Символи віддаються приймачу
+// одразу, тож відповідь може йти прямо в чергу TX без проміжного
+// буфера. Стану між викликами немає - функції реентерабельні.
+
+typedef struct {
+    char *buffer;
+    uint16_t size;
+    uint16_t length;
+} FormatBuffer;
+
+static void Format_PutBuffer(void *context, char c) {
+    FormatBuffer *target = context;
+    if (target->length + 1 < target->size) {
+        target->buffer[target->length++] = c;
+    }
+}
+
+// Число з вирівнюванням: цифри збираються з кінця в локальний масив
+static uint16_t Format_Number(FormatPut put, void *context, uint32_t value, uint8_t negative,
+                              uint8_t base, uint8_t upper, uint8_t width, char pad, uint8_t left) {
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char text[11];
+    uint8_t count = 0;
+    uint16_t written = 0;
+
+    do {
+        text[count++] = digits[value % base];
+        value /= base;
+    } while (value != 0);
+
+    uint8_t length = count + negative;
+    if (negative && pad == '0') {
+        put(context, '-');
+        written++;
+        negative = 0;
+    }
+    while (!left && width > length) {
+        put(context, pad);
+        written++;
+        width--;
+    }
+    if (negative) {
+        put(context, '-');
+        written++;
+    }
+    while (count > 0) {
+        put(context, text[--count]);
+        written++;
+    }
+    while (left && width > length) {
+        put(context, ' ');
+        written++;
+        width--;
+    }
+    return written;
+}
+
+uint16_t Format_Vprint(FormatPut put, void *context, const char *format, va_list args) {
+    uint16_t written = 0;
+
+    for (; *format != '\0'; format++) {
+        if (*format != '%') {
+            put(context, *format);
+            written++;
+            continue;
+        }
+        format++;
+        uint8_t left = 0;
+        char pad = ' ';
+        uint8_t width = 0;
+        for (; *format == '-' || *format == '0'; format++) {
+            if (*format == '-') {
+                left = 1;
+            } else {
+                pad = '0';
+            }
+        }
+        for (; *format >= '0' && *format <= '9'; format++) {
+            width = width * 10 + (*format - '0');
+        }
+        if (*format == 'l') {
+            format++; // long і int на Cortex-M однакові
+        }
+        if (left) {
+            pad = ' ';
+        }
+
+        switch (*format) {
+            case 'd':
+            case 'i': {
+                int32_t value = va_arg(args, int32_t);
+                uint32_t magnitude = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+                written += Format_Number(put, context, magnitude, value < 0, 10, 0, width, pad, left);
+                break;
+            }
+            case 'u':
+                written += Format_Number(put, context, va_arg(args, uint32_t), 0, 10, 0, width, pad, left);
+                break;
+            case 'x':
+            case 'X':
+                written += Format_Number(put, context, va_arg(args, uint32_t), 0, 16,
+                                         *format == 'X', width, pad, left);
+                break;
+            case 'c':
+                put(context, (char)va_arg(args, int));
+                written++;
+                break;
+            case 's': {
+                const char *text = va_arg(args, const char *);
+                uint16_t length = 0;
+                while (text[length] != '\0') {
+                    length++;
+                }
+                for (; !left && width > length; width--, written++) {
+                    put(context, ' ');
+                }
+                for (uint16_t i = 0; i < length; i++, written++) {
+                    put(context, text[i]);
+                }
+                for (; left && width > length; width--, written++) {
+                    put(context, ' ');
+                }
+                break;
+            }
+            case '%':
+                put(context, '%');
+                written++;
+                break;
+            case '\0':
+                return written; // '%' у кінці рядка
+            default:
+                put(context, '?');
+                written++;
+                break;
+        }
+    }
+    return written;
+}
+
+uint16_t Format_Print(FormatPut put, void *context, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    uint16_t written = Format_Vprint(put, context, format, args);
+    va_end(args);
+    return written;
+}
+
+// Заміна snprintf: рядок завжди завершено '\0', повертає довжину без обрізання
+uint16_t Format_Buffer(char *buffer, uint16_t size, const char *format, ...) {
+    FormatBuffer target = { buffer, size, 0 };
+    va_list args;
+
+    va_start(args, format);
+    uint16_t written = Format_Vprint(Format_PutBuffer, &target, format, args);
+    va_end(args);
+    if (size > 0) {
+        buffer[target.length] = '\0';
+    }
+    return written;
+}
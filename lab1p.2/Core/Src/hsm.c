@@ -0,0 +1,152 @@
+#include "hsm.h"
+
+// Ієрархічний автомат станів на таблицях. Стани й переходи описуються
+// константними масивами (лишаються у flash); під час Hsm_Init кожен
+// стан успадковує переходи предків, яких не перевизначив, і таблиця
+// [стан][подія] зводиться в RAM. Тому диспетчеризація події - один
+// доступ до масиву незалежно від глибини ієрархії; лише сам перехід
+// проходить ланцюжки виходів і входів до спільного предка.
+// Перехід виконується як локальний: виходимо лише до спільного предка
+// поточного і цільового станів, потім дія переходу, потім входи і
+// спуск по початкових підстанах до листового стану.
+
+static uint8_t Hsm_Depth(const Hsm *hsm, uint8_t state) {
+    uint8_t depth = 0;
+    while (hsm->states[state].parent != HSM_NONE) {
+        state = hsm->states[state].parent;
+        depth++;
+    }
+    return depth;
+}
+
+void Hsm_Init(Hsm *hsm, const HsmState *states, uint8_t stateCount, void *context) {
+    if (stateCount > HSM_MAX_STATES) {
+        Error_Handler();
+    }
+    // Шлях входу в Hsm_Transit розрахований на HSM_MAX_DEPTH рівнів;
+    // обхід з лічильником заодно ловить цикл у ланцюжку батьків
+    for (uint8_t state = 0; state < stateCount; state++) {
+        uint8_t depth = 0;
+        for (uint8_t owner = states[state].parent; owner != HSM_NONE; owner = states[owner].parent) {
+            if (owner >= stateCount || ++depth >= HSM_MAX_DEPTH) {
+                Error_Handler();
+            }
+        }
+    }
+    hsm->states = states;
+    hsm->stateCount = stateCount;
+    hsm->current = HSM_NONE;
+    hsm->context = context;
+
+    for (uint8_t state = 0; state < stateCount; state++) {
+        for (uint8_t event = 0; event < HSM_MAX_EVENTS; event++) {
+            hsm->table[state][event] = NULL;
+        }
+        // Від стану до кореня: найближче визначення перекриває предків
+        for (uint8_t owner = state; owner != HSM_NONE; owner = states[owner].parent) {
+            for (uint8_t i = 0; i < states[owner].transitionCount; i++) {
+                const HsmTransition *transition = &states[owner].transitions[i];
+                if (transition->event < HSM_MAX_EVENTS && hsm->table[state][transition->event] == NULL) {
+                    hsm->table[state][transition->event] = transition;
+                }
+            }
+        }
+    }
+}
+
+// Вхід у стан і спуск по початкових підстанах
+static void Hsm_Drill(Hsm *hsm, uint8_t state, const Event *event) {
+    while (hsm->states[state].initial != HSM_NONE) {
+        state = hsm->states[state].initial;
+        if (hsm->states[state].entry != NULL) {
+            hsm->states[state].entry(hsm, event);
+        }
+    }
+    hsm->current = state;
+}
+
+void Hsm_Start(Hsm *hsm) {
+    uint8_t root = 0;
+    while (hsm->states[root].parent != HSM_NONE) {
+        root = hsm->states[root].parent;
+    }
+    if (hsm->states[root].entry != NULL) {
+        hsm->states[root].entry(hsm, NULL);
+    }
+    Hsm_Drill(hsm, root, NULL);
+}
+
+static void Hsm_Transit(Hsm *hsm, const HsmTransition *transition, const Event *event) {
+    const HsmState *states = hsm->states;
+    uint8_t source = hsm->current;
+    uint8_t target = transition->target;
+    uint8_t path[HSM_MAX_DEPTH];
+    uint8_t pathLength = 0;
+
+    // Спільний предок; перехід у себе або в предка - повторний вхід
+    uint8_t a = source;
+    uint8_t b = target;
+    uint8_t depthA = Hsm_Depth(hsm, a);
+    uint8_t depthB = Hsm_Depth(hsm, b);
+    while (depthA > depthB) {
+        a = states[a].parent;
+        depthA--;
+    }
+    while (depthB > depthA) {
+        path[pathLength++] = b;
+        b = states[b].parent;
+        depthB--;
+    }
+    while (a != b) {
+        a = states[a].parent;
+        path[pathLength++] = b;
+        b = states[b].parent;
+    }
+    uint8_t ancestor = a;
+    if (ancestor == target) {
+        path[pathLength++] = target;
+        ancestor = states[target].parent;
+    }
+
+    for (uint8_t state = source; state != ancestor; state = states[state].parent) {
+        if (states[state].exit != NULL) {
+            states[state].exit(hsm, event);
+        }
+    }
+    if (transition->action != NULL) {
+        transition->action(hsm, event);
+    }
+    while (pathLength > 0) {
+        uint8_t state = path[--pathLength];
+        if (states[state].entry != NULL) {
+            states[state].entry(hsm, event);
+        }
+    }
+    Hsm_Drill(hsm, target, event);
+}
+
+void Hsm_Dispatch(Hsm *hsm, const Event *event) {
+    if (event->type >= HSM_MAX_EVENTS) {
+        return;
+    }
+    const HsmTransition *transition = hsm->table[hsm->current][event->type];
+    if (transition == NULL) {
+        return; // Подія не обробляється в поточному стані
+    }
+    if (transition->target == HSM_INTERNAL) {
+        if (transition->action != NULL) {
+            transition->action(hsm, event);
+        }
+    } else {
+        Hsm_Transit(hsm, transition, event);
+    }
+}
+
+uint8_t Hsm_IsIn(const Hsm *hsm, uint8_t state) {
+    for (uint8_t current = hsm->current; current != HSM_NONE; current = hsm->states[current].parent) {
+        if (current == state) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "isr_monitor.h"
+#include <string.h>
+
+// Монітор переривань на лічильнику тактів DWT (вмикає Bench_Init).
+// Обробник бере мітку на вході і на виході; з різниці віднімається час
+// вкладених переривань, тож кожне враховує лише власне виконання.
+// Затримку від запиту до входу можна виміряти лише для SysTick: з його
+// лічильника видно, скільки тактів минуло від перезавантаження. Вона
+// включає і маскування (__disable_irq), і витіснення старшими
+// перериваннями.
+// Статистику читає головний цикл без маскування переривань: кожен
+// запис має лічильник версії (seqlock), і читач повторює копіювання,
+// якщо обробник оновив запис посередині.
+
+typedef struct {
+    volatile uint32_t version; // Непарне - запис оновлюється
+    IsrMonitorStats stats;
+} IsrMonitorRecord;
+
+volatile uint32_t isrMonitorBusy;  // Сумарні власні такти всіх обробників
+static IsrMonitorRecord records[ISR_MONITOR_COUNT];
+static const char *const names[ISR_MONITOR_COUNT] = {
+    "BUTTON", "UART", "DMA", "TICK", "WAKE"
+};
+
+static uint32_t windowStart;  // Тік початку вікна завантаження
+static uint32_t windowBusy;   // isrMonitorBusy на початку вікна
+static volatile uint16_t loadPermille;
+
+#if ISR_MONITOR_ENABLED
+static HOT_FUNC uint8_t IsrMonitor_Bucket(uint32_t cycles) {
+    int32_t bits = 32 - __CLZ(cycles);
+    int32_t bucket = (bits - 5) / 2;
+    if (bucket < 0) {
+        return 0;
+    }
+    return bucket >= ISR_MONITOR_BUCKETS ? ISR_MONITOR_BUCKETS - 1 : (uint8_t)bucket;
+}
+
+// Завантаження за останнє вікно; час беремо з тіку, бо CYCCNT стоїть
+// у сні, а частота ядра змінюється (dvfs.c)
+static HOT_FUNC void IsrMonitor_Window(void) {
+    uint32_t now = HAL_GetTick();
+    uint32_t elapsed = now - windowStart;
+    if (elapsed < ISR_MONITOR_WINDOW_MS) {
+        return;
+    }
+    uint32_t busy = isrMonitorBusy;
+    uint64_t total = (uint64_t)elapsed * (SystemCoreClock / 1000);
+    uint64_t permille = (uint64_t)(busy - windowBusy) * 1000 / total;
+    loadPermille = permille > 1000 ? 1000 : (uint16_t)permille;
+    windowStart = now;
+    windowBusy = busy;
+}
+
+HOT_FUNC void IsrMonitor_Exit(const IsrFrame *frame, IsrMonitorIrq irq, uint32_t latency) {
+    uint32_t total = DWT->CYCCNT - frame->start;
+    uint32_t busy;
+    uint32_t own;
+
+    // Вкладені обробники вже додали свій час до isrMonitorBusy
+    do {
+        busy = __LDREXW(&isrMonitorBusy);
+        own = total - (busy - frame->inner);
+    } while (__STREXW(busy + own, &isrMonitorBusy));
+
+    // Одне переривання не вкладається саме в себе, тож запис має
+    // єдиного записувача
+    IsrMonitorRecord *record = &records[irq];
+    IsrMonitorStats *stats = &record->stats;
+    record->version++;
+    __DMB();
+    stats->count++;
+    stats->duration[IsrMonitor_Bucket(own)]++;
+    if (own > stats->maxDuration) {
+        stats->maxDuration = own;
+    }
+    if (latency != ISR_MONITOR_NO_LATENCY) {
+        stats->latency[IsrMonitor_Bucket(latency)]++;
+        if (latency > stats->maxLatency) {
+            stats->maxLatency = latency;
+        }
+    }
+    __DMB();
+    record->version++;
+
+    if (irq == ISR_MONITOR_TICK) {
+        IsrMonitor_Window();
+    }
+}
+#endif
+
+void IsrMonitor_GetStats(IsrMonitorIrq irq, IsrMonitorStats *stats) {
+    const IsrMonitorRecord *record = &records[irq];
+    uint32_t version;
+
+    do {
+        version = record->version;
+        __DMB();
+        memcpy(stats, (const void *)&record->stats, sizeof(*stats));
+        __DMB();
+    } while ((version & 1) || version != record->version);
+}
+
+const char *IsrMonitor_Name(IsrMonitorIrq irq) {
+    return names[irq];
+}
+
+// Частка часу в обробниках переривань, проміле
+uint16_t IsrMonitor_Load(void) {
+    return loadPermille;
+}
@@ -0,0 +1,370 @@
+#include "kernel.h"
+#include "deferred.h"
+#include <string.h>
+
+// Мінімальне витісняльне ядро з фіксованими пріоритетами. Перемикання
+// контексту - у PendSV з найнижчим пріоритетом: апаратура зберігає
+// R0-R3, R12, LR, PC, xPSR, обробник - R4-R11, EXC_RETURN і, лише якщо
+// задача користувалась FPU, S16-S31 (решту регістрів FPU зберігає
+// лінивий стекінг). Стеки задач статичні, купа не використовується.
+//
+// Готові задачі - бітова маска за пріоритетами, вибір наступної - одна
+// інструкція CLZ. Критичні секції ядра маскують переривання через
+// PRIMASK; їх найдовша тривалість (плюс ~12 тактів входу у виняток)
+// і є найгіршою додатковою затримкою переривань через ядро.
+// Блокуючі функції не можна викликати з вимкненими перериваннями.
+
+#if KERNEL_ENABLED
+
+// Використовуються з асемблера PendSV_Handler
+KernelTask *volatile kernelCurrent = NULL;
+KernelTask *volatile kernelNext = NULL;
+volatile uint32_t kernelSwitches = 0; // Лише справжні зміни задачі
+
+static KernelTask *tasks[KERNEL_PRIORITIES];
+static volatile uint32_t readyMask = 0;
+static volatile uint32_t sleepMask = 0;   // Задачі з тайм-аутом
+static uint8_t kernelRunning = 0;
+static volatile KernelStats kernelStats;
+
+static KernelTask idleTask;
+static uint32_t idleStack[KERNEL_IDLE_STACK] __ALIGNED(8);
+static volatile uint32_t idleCycles = 0;  // Такти в WFI
+static uint32_t loadIdleMark = 0;         // idleCycles на початку секунди
+static uint32_t loadTicks = 0;
+
+static uint32_t lockStart;
+
+static inline uint32_t Kernel_Lock(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!primask) {
+        lockStart = DWT->CYCCNT;
+    }
+    return primask;
+}
+
+static inline void Kernel_Unlock(uint32_t primask) {
+    if (!primask) {
+        uint32_t cycles = DWT->CYCCNT - lockStart;
+        if (cycles > kernelStats.maxLockCycles) {
+            kernelStats.maxLockCycles = cycles;
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+static inline uint8_t Kernel_Highest(uint32_t mask) {
+    return 31 - __CLZ(mask);
+}
+
+// Вибір задачі з найвищим пріоритетом; перемикання відбудеться в PendSV,
+// щойно буде знято маску переривань і завершаться всі інші обробники
+static void Kernel_Schedule(void) {
+    if (!kernelRunning) {
+        return;
+    }
+    KernelTask *next = tasks[Kernel_Highest(readyMask)];
+    kernelNext = next;
+    if (next != kernelCurrent) {
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+}
+
+static void Kernel_Wake(KernelTask *task, uint8_t result) {
+    uint32_t bit = 1UL << task->priority;
+    if (task->waitList != NULL) {
+        *task->waitList &= ~bit;
+        task->waitList = NULL;
+    }
+    sleepMask &= ~bit;
+    readyMask |= bit;
+    task->result = result;
+}
+
+// Будить задачу з найвищим пріоритетом зі списку очікування
+static void Kernel_WakeFirst(volatile uint32_t *waitList) {
+    Kernel_Wake(tasks[Kernel_Highest(*waitList)], 1);
+    Kernel_Schedule();
+}
+
+// Знімає поточну задачу з готових; викликається під Kernel_Lock,
+// саме перемикання - після Kernel_Unlock
+static void Kernel_Block(volatile uint32_t *waitList, uint32_t timeout) {
+    KernelTask *task = kernelCurrent;
+    uint32_t bit = 1UL << task->priority;
+
+    readyMask &= ~bit;
+    task->result = 0;
+    task->waitList = waitList;
+    if (waitList != NULL) {
+        *waitList |= bit;
+    }
+    if (timeout != KERNEL_WAIT_FOREVER) {
+        task->wakeTick = HAL_GetTick() + timeout;
+        sleepMask |= bit;
+    }
+    Kernel_Schedule();
+}
+
+static void Kernel_TaskExit(void) {
+    // Задача не повинна повертатися: назавжди знімаємо її з виконання
+    uint32_t primask = Kernel_Lock();
+    Kernel_Block(NULL, KERNEL_WAIT_FOREVER);
+    Kernel_Unlock(primask);
+    while (1) {
+    }
+}
+
+// Задача простою: сон до переривання з обліком часу сну
+static void Kernel_Idle(void *argument) {
+    (void)argument;
+    while (1) {
+        __disable_irq();
+        uint32_t start = DWT->CYCCNT;
+        __WFI();
+        idleCycles += DWT->CYCCNT - start;
+        __enable_irq(); // Тут виконується обробник, що розбудив ядро
+    }
+}
+
+void Kernel_CreateTask(KernelTask *task, const char *name, KernelEntry entry, void *argument,
+                       uint32_t *stack, uint32_t stackWords, uint8_t priority) {
+    uint32_t *sp = (uint32_t *)((uint32_t)(stack + stackWords) & ~7UL);
+
+    // Кадр, який апаратура знімає при виході з винятку
+    *--sp = 0x01000000UL;              // xPSR: біт Thumb
+    *--sp = (uint32_t)entry;           // PC
+    *--sp = (uint32_t)Kernel_TaskExit; // LR
+    *--sp = 0;                         // R12
+    *--sp = 0;                         // R3
+    *--sp = 0;                         // R2
+    *--sp = 0;                         // R1
+    *--sp = (uint32_t)argument;        // R0
+    // Кадр PendSV: EXC_RETURN (потік, PSP, без FPU) і R11..R4
+    *--sp = 0xFFFFFFFDUL;
+    for (uint8_t i = 0; i < 8; i++) {
+        *--sp = 0;
+    }
+
+    task->sp = sp;
+    task->name = name;
+    task->priority = priority;
+    task->result = 0;
+    task->waitList = NULL;
+
+    uint32_t primask = Kernel_Lock();
+    tasks[priority] = task;
+    readyMask |= 1UL << priority;
+    Kernel_Schedule();
+    Kernel_Unlock(primask);
+}
+
+void Kernel_Start(void) {
+    Kernel_CreateTask(&idleTask, "idle", Kernel_Idle, NULL, idleStack, KERNEL_IDLE_STACK, 0);
+
+    // Перемикання не повинно витісняти жодне переривання
+    NVIC_SetPriority(PendSV_IRQn, IRQ_PRIORITY_DEFERRED);
+
+    __disable_irq();
+    __set_PSP(0); // Ознака для PendSV: контекст main() не зберігається
+    kernelCurrent = NULL;
+    kernelRunning = 1;
+    loadIdleMark = idleCycles;
+    Kernel_Schedule();
+    __enable_irq();
+
+    while (1) {
+        // Сюди керування вже не повертається
+    }
+}
+
+uint8_t Kernel_IsRunning(void) {
+    return kernelRunning;
+}
+
+// З SysTick: завершення тайм-аутів і облік завантаження
+void Kernel_Tick(void) {
+    if (!kernelRunning) {
+        return;
+    }
+    uint32_t now = HAL_GetTick();
+    uint32_t primask = Kernel_Lock();
+    uint32_t sleeping = sleepMask;
+    while (sleeping) {
+        KernelTask *task = tasks[Kernel_Highest(sleeping)];
+        sleeping &= ~(1UL << task->priority);
+        if ((int32_t)(now - task->wakeTick) >= 0) {
+            Kernel_Wake(task, 0);
+        }
+    }
+    Kernel_Schedule();
+    Kernel_Unlock(primask);
+
+    if (++loadTicks >= 1000) {
+        uint32_t idle = idleCycles - loadIdleMark;
+        uint32_t percent = idle / (SystemCoreClock / 100);
+        kernelStats.load = (percent < 100) ? 100 - percent : 0;
+        loadIdleMark += idle;
+        loadTicks = 0;
+    }
+}
+
+void Kernel_Delay(uint32_t ms) {
+    if (ms == 0) {
+        return;
+    }
+    uint32_t primask = Kernel_Lock();
+    Kernel_Block(NULL, ms);
+    Kernel_Unlock(primask);
+}
+
+void Kernel_SemInit(KernelSemaphore *sem, uint16_t initial, uint16_t max) {
+    sem->count = initial;
+    sem->max = max;
+    sem->waiters = 0;
+}
+
+uint8_t Kernel_SemTake(KernelSemaphore *sem, uint32_t timeout) {
+    uint32_t primask = Kernel_Lock();
+    if (sem->count > 0) {
+        sem->count--;
+        Kernel_Unlock(primask);
+        return 1;
+    }
+    if (timeout == 0) {
+        Kernel_Unlock(primask);
+        return 0;
+    }
+    // Семафор віддається задачі напряму, лічильник не змінюється
+    Kernel_Block(&sem->waiters, timeout);
+    Kernel_Unlock(primask);
+    return kernelCurrent->result;
+}
+
+void Kernel_SemGive(KernelSemaphore *sem) {
+    uint32_t primask = Kernel_Lock();
+    if (sem->waiters) {
+        Kernel_WakeFirst(&sem->waiters);
+    } else if (sem->count < sem->max) {
+        sem->count++;
+    }
+    Kernel_Unlock(primask);
+}
+
+void Kernel_QueueInit(KernelQueue *queue, void *buffer, uint16_t itemSize, uint16_t capacity) {
+    queue->buffer = buffer;
+    queue->itemSize = itemSize;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->receivers = 0;
+    queue->senders = 0;
+}
+
+// Тайм-аут відраховується заново після кожного пробудження, якщо
+// звільнене місце встигла зайняти інша задача
+uint8_t Kernel_QueueSend(KernelQueue *queue, const void *item, uint32_t timeout) {
+    uint32_t primask = Kernel_Lock();
+    while (queue->count == queue->capacity) {
+        if (timeout == 0) {
+            Kernel_Unlock(primask);
+            return 0;
+        }
+        Kernel_Block(&queue->senders, timeout);
+        Kernel_Unlock(primask);
+        if (!kernelCurrent->result) {
+            return 0;
+        }
+        primask = Kernel_Lock();
+    }
+    uint16_t slot = (queue->head + queue->count) % queue->capacity;
+    memcpy(&queue->buffer[slot * queue->itemSize], item, queue->itemSize);
+    queue->count++;
+    if (queue->receivers) {
+        Kernel_WakeFirst(&queue->receivers);
+    }
+    Kernel_Unlock(primask);
+    return 1;
+}
+
+uint8_t Kernel_QueueReceive(KernelQueue *queue, void *item, uint32_t timeout) {
+    uint32_t primask = Kernel_Lock();
+    while (queue->count == 0) {
+        if (timeout == 0) {
+            Kernel_Unlock(primask);
+            return 0;
+        }
+        Kernel_Block(&queue->receivers, timeout);
+        Kernel_Unlock(primask);
+        if (!kernelCurrent->result) {
+            return 0;
+        }
+        primask = Kernel_Lock();
+    }
+    memcpy(item, &queue->buffer[queue->head * queue->itemSize], queue->itemSize);
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+    if (queue->senders) {
+        Kernel_WakeFirst(&queue->senders);
+    }
+    Kernel_Unlock(primask);
+    return 1;
+}
+
+void Kernel_GetStats(KernelStats *stats) {
+    __disable_irq();
+    *stats = *(const KernelStats *)&kernelStats;
+    stats->switches = kernelSwitches;
+    __enable_irq();
+}
+
+// Спершу - нижні половини переривань (deferred.c), потім перемикання
+// контексту. При першому запуску PSP = 0 і зберігати нічого.
+// Перемикання рахуються тут, а не в Kernel_Schedule: запит на PendSV
+// може бути скасовано новим вибором до виконання, а PendSV від нижніх
+// половин лишає ту саму задачу.
+void __attribute__((naked)) PendSV_Handler(void) {
+    __asm volatile (
+        "    push     {r3, lr}                         \n" // Стек MSP вирівняно на 8
+        "    bl       Deferred_Drain                   \n"
+        "    pop      {r3, lr}                         \n"
+        "    mrs      r0, psp                          \n"
+        "    cbz      r0, 1f                           \n"
+        "    tst      lr, #0x10                        \n" // Задача використовувала FPU?
+        "    it       eq                               \n"
+        "    vstmdbeq r0!, {s16-s31}                   \n"
+        "    stmdb    r0!, {r4-r11, lr}                \n"
+        "    movw     r1, #:lower16:kernelCurrent      \n"
+        "    movt     r1, #:upper16:kernelCurrent      \n"
+        "    ldr      r1, [r1]                         \n"
+        "    str      r0, [r1]                         \n"
+        "1:                                            \n"
+        "    cpsid    i                                \n"
+        "    movw     r1, #:lower16:kernelCurrent      \n"
+        "    movt     r1, #:upper16:kernelCurrent      \n"
+        "    movw     r2, #:lower16:kernelNext         \n"
+        "    movt     r2, #:upper16:kernelNext         \n"
+        "    ldr      r2, [r2]                         \n"
+        "    ldr      r3, [r1]                         \n"
+        "    str      r2, [r1]                         \n"
+        "    cmp      r3, r2                           \n" // Задача змінилась?
+        "    beq      2f                               \n"
+        "    movw     r3, #:lower16:kernelSwitches     \n"
+        "    movt     r3, #:upper16:kernelSwitches     \n"
+        "    ldr      r0, [r3]                         \n"
+        "    adds     r0, #1                           \n"
+        "    str      r0, [r3]                         \n"
+        "2:                                            \n"
+        "    cpsie    i                                \n"
+        "    ldr      r0, [r2]                         \n"
+        "    ldmia    r0!, {r4-r11, lr}                \n"
+        "    tst      lr, #0x10                        \n"
+        "    it       eq                               \n"
+        "    vldmiaeq r0!, {s16-s31}                   \n"
+        "    msr      psp, r0                          \n"
+        "    bx       lr                               \n"
+    );
+}
+
+#endif /* KERNEL_ENABLED */
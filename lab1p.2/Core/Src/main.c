@@ -1,12 +1,24 @@
 #include "main.h"
+#include "bus.h"
+#include "uart_link.h"
+#include "command.h"
+#include "reply.h"
+#include "timer_wheel.h"
+#include "kernel.h"
+#include "power.h"
+#include "dvfs.h"
+#include "deferred.h"
+#include "settings.h"
+#include "retain.h"
+#include "vectors.h"
+#include "boot.h"
 #include <string.h>
-#include <stdio.h>
-#include <ctype.h>
 
 
 // Оголошення глобальних змінних
 UART_HandleTypeDef huart2; // Дескриптор UART2
 TIM_HandleTypeDef htim2;   // Дескриптор таймера TIM2
+DMA_HandleTypeDef hdma_usart2_tx; // Канал DMA для передачі UART2
 
 // Глобальні змінні
 volatile uint8_t brightness = 50;  // Поточна яскравість (50%)
@@ -15,95 +27,204 @@ volatile uint8_t ledState = 1;     // Стан світлодіода (1 - ув
 // Прототипи функцій
 void SystemClock_Config(void);
 void MX_GPIO_Init(void);
+void MX_DMA_Init(void);
 void MX_USART2_UART_Init(void);
 void MX_TIM2_Init(void);
 void Error_Handler(void);
 
-// Обробник переривання для кнопки B1
-void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+// Брязкіт контактів кнопки: повторні фронти в цьому вікні ігноруються
+#define BUTTON_DEBOUNCE_MS 50
+
+static void Button_Work(uint32_t tick);
+static DeferredQueue buttonWork = { .handler = Button_Work };
+
+// Нижня половина кнопки (PendSV): антибрязкіт і перемикання світлодіода
+static void Button_Work(uint32_t tick) {
+    static uint32_t lastPress = (uint32_t)-BUTTON_DEBOUNCE_MS;
+
+    if (tick - lastPress < BUTTON_DEBOUNCE_MS) {
+        return;
+    }
+    lastPress = tick;
+    ledState = !ledState; // Змінюємо стан світлодіода
+    if (ledState) {
+        // Відновлення яскравості, якщо світлодіод увімкнено
+        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, brightness * 10);
+    } else {
+        // Гасимо світлодіод
+        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, 0);
+    }
+}
+
+// Обробник переривання для кнопки B1: лише час натискання
+HOT_FUNC void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
     if (GPIO_Pin == GPIO_PIN_13) { // Якщо натиснуто кнопку B1
-        ledState = !ledState; // Змінюємо стан світлодіода
-        if (ledState) {
-            // Відновлення яскравості, якщо світлодіод увімкнено
-            __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, brightness * 10);
-        } else {
-            // Гасимо світлодіод
-            __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, 0);
+        Deferred_Post(&buttonWork, HAL_GetTick());
+    }
+}
+
+#if KERNEL_ENABLED
+// Задачі ядра: протокол UART і таймери (ефекти, підтвердження) мають
+// власні стеки і пріоритети; спільний стан застосунку захищає appLock
+#define PROTOCOL_PRIORITY     2
+#define PROTOCOL_STACK_WORDS  512
+#define TIMER_PRIORITY        3 // Ефекти не повинні чекати на розбір команд
+#define TIMER_STACK_WORDS     384
+
+static KernelTask protocolTask;
+static KernelTask timerTask;
+static uint32_t protocolStack[PROTOCOL_STACK_WORDS] __ALIGNED(8);
+static uint32_t timerStack[TIMER_STACK_WORDS] __ALIGNED(8);
+static KernelSemaphore lineReady;  // Переривання UART -> протокол
+static KernelSemaphore timerReady; // SysTick -> таймери
+static KernelSemaphore appLock;    // Яскравість, режим відповідей, черга TX
+
+void UartLink_LineCallback(void) {
+    Kernel_SemGive(&lineReady);
+}
+
+void TimerWheel_ExpiredCallback(void) {
+    Kernel_SemGive(&timerReady);
+}
+
+static void ProtocolTask(void *argument) {
+    (void)argument;
+    while (1) {
+        Kernel_SemTake(&lineReady, KERNEL_WAIT_FOREVER);
+        UartLine *line;
+        while ((line = UartLink_TakeLine()) != NULL) {
+            Kernel_SemTake(&appLock, KERNEL_WAIT_FOREVER);
+            Command_Execute(line);
+            Settings_Poll();
+            Kernel_SemGive(&appLock);
+            UartLink_ReleaseLine(line);
         }
     }
 }
 
+static void TimerTask(void *argument) {
+    (void)argument;
+    while (1) {
+        Kernel_SemTake(&timerReady, KERNEL_WAIT_FOREVER);
+        Kernel_SemTake(&appLock, KERNEL_WAIT_FOREVER);
+        TimerWheel_Dispatch();
+        Settings_Poll();
+        Kernel_SemGive(&appLock);
+    }
+}
+#endif
+
+// Світлодіод зі збереженими яскравістю і станом: GPIO, TIM2, параметри
+// і PWM. Частота PWM залежить від тактування ядра, коефіцієнт
+// заповнення - ні, тож до SystemClock_Config яскравість уже правильна.
+static void Led_Start(void) {
+    MX_GPIO_Init();
+    MX_TIM2_Init();
+    Boot_Mark("gpio");
+
+    // Яскравість, стан світлодіода і режим відповідей: після скидання -
+    // з резервного регістра, після вимкнення живлення - з flash
+    Settings_Init();
+    Settings_Restore();
+    Boot_Mark("settings");
+
+    // Запуск PWM на TIM2 (канал 1) для керування яскравістю світлодіода
+    __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, ledState ? brightness * 10 : 0);
+    HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_1);
+    Boot_Mark("led");
+}
+
 int main(void) {
+    // Лічильник тактів для профілю завантаження і команди BENCH
+    Boot_Start();
+
     // Ініціалізація HAL-бібліотеки
     HAL_Init();
 
+    // Причина скидання і доступ до резервних регістрів
+    Retain_Init();
+
+    // Таблиця векторів у SRAM - до запуску переривань периферії
+    Vectors_Init();
+
+    // Нижні половини переривань - до ввімкнення самих переривань
+    Deferred_Init();
+    Deferred_Register(&buttonWork, 0);
+    Boot_Mark("hal");
+
+#if BOOT_FAST_ENABLED
+    // Світло - першим, до решти периферії
+    Led_Start();
+#endif
+
     // Налаштування системного тактування
     SystemClock_Config();
+    Boot_Mark("clock");
 
-    // Ініціалізація GPIO, UART2 та таймера TIM2
-    MX_GPIO_Init();
+    // Ініціалізація DMA та UART2
+    MX_DMA_Init();
     MX_USART2_UART_Init();
-    MX_TIM2_Init();
+    Boot_Mark("uart");
 
-    // Запуск PWM на TIM2 (канал 1) для керування яскравістю світлодіода
-    HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_1);
-    __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, brightness * 10); // Встановлення початкової яскравості
+    // Запуск LSE для сну без SysTick
+    Power_Init();
+
+    // Зниження частоти після періоду без команд
+    Dvfs_Init();
 
-    // Відправлення вітального повідомлення через UART
-    char welcomeMessage[] = "Brightness control is active\r\n";
-    HAL_UART_Transmit(&huart2, (uint8_t *)welcomeMessage, strlen(welcomeMessage), HAL_MAX_DELAY);
+    // Вузол шини засинає в mute до свого адресного байта
+    Bus_Init(&huart2);
+    Boot_Mark("power");
 
-    // Буфери для команд і відповідей UART
-    uint8_t buffer[100]; // Буфер для прийому даних
-    uint8_t response[100]; // Буфер для відповіді
-    uint16_t index = 0;    // Поточний індекс буфера
+#if !BOOT_FAST_ENABLED
+    Led_Start();
+
+    // Відправлення вітального повідомлення через UART (на шині мовчимо)
+    if (!BUS_MODE_ENABLED) {
+        char welcomeMessage[] = "Brightness control is active\r\n";
+        HAL_UART_Transmit(&huart2, (uint8_t *)welcomeMessage, strlen(welcomeMessage), HAL_MAX_DELAY);
+    }
+#endif
+
+    // Прийом UART по перериваннях, без блокування головного циклу
+    UartLink_Start(&huart2);
+
+#if BOOT_FAST_ENABLED
+    // Вітальне повідомлення - через чергу TX, не чекаючи ~30 мс передачі
+    if (!BUS_MODE_ENABLED) {
+        static const char welcomeMessage[] = "Brightness control is active\r\n";
+        UartLink_Write((const uint8_t *)welcomeMessage, sizeof(welcomeMessage) - 1);
+    }
+#endif
+    Boot_Mark("ready");
+
+#if KERNEL_ENABLED
+    Kernel_SemInit(&lineReady, 0, 1);
+    Kernel_SemInit(&timerReady, 0, 1);
+    Kernel_SemInit(&appLock, 1, 1);
+    Kernel_CreateTask(&protocolTask, "protocol", ProtocolTask, NULL,
+                      protocolStack, PROTOCOL_STACK_WORDS, PROTOCOL_PRIORITY);
+    Kernel_CreateTask(&timerTask, "timer", TimerTask, NULL,
+                      timerStack, TIMER_STACK_WORDS, TIMER_PRIORITY);
+    Kernel_Start(); // Далі main() не виконується
+#endif
 
     while (1) {
-        uint8_t data; // Змінна для зберігання отриманого символа
-        // Прийом символа через UART
-        if (HAL_UART_Receive(&huart2, &data, 1, HAL_MAX_DELAY) == HAL_OK) {
-            if (data == '\n' || data == '\r') {
-                // Якщо отримано символ завершення рядка
-                buffer[index] = '\0'; // Завершуємо рядок у буфері
-                if (index > 0) {
-                    // Перевірка команди в буфері
-                    if (tolower(buffer[0]) == 'l' && buffer[1] == '=') {
-                        int new_brightness = -1;
-                        // Зчитування нового значення яскравості
-                        if (sscanf((char *)&buffer[2], "%d", &new_brightness) == 1 && new_brightness >= 0 && new_brightness <= 99) {
-                            brightness = new_brightness; // Оновлення яскравості
-                            if (ledState) {
-                                // Застосування нової яскравості, якщо світлодіод увімкнено
-                                __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, brightness * 10);
-                            }
-                            // Відправка відповіді через UART
-                            snprintf((char *)response, sizeof(response), "Brightness set to %d\r\n", brightness);
-                            HAL_UART_Transmit(&huart2, response, strlen((char *)response), HAL_MAX_DELAY);
-                        } else {
-                            // Якщо значення некоректне
-                            snprintf((char *)response, sizeof(response), "Error: Invalid value\r\n");
-                            HAL_UART_Transmit(&huart2, response, strlen((char *)response), HAL_MAX_DELAY);
-                        }
-                    } else {
-                        // Якщо команда некоректна
-                        snprintf((char *)response, sizeof(response), "Error: Invalid command\r\n");
-                        HAL_UART_Transmit(&huart2, response, strlen((char *)response), HAL_MAX_DELAY);
-                    }
-                }
-                // Очищення буфера після обробки команди
-                memset(buffer, 0, sizeof(buffer));
-                index = 0;
-            } else {
-                // Додавання символа до буфера
-                if (index < sizeof(buffer) - 1) {
-                    buffer[index++] = data;
-                } else {
-                    // Якщо команда занадто довга
-                    index = 0;
-                    snprintf((char *)response, sizeof(response), "Error: Command too long\r\n");
-                    HAL_UART_Transmit(&huart2, response, strlen((char *)response), HAL_MAX_DELAY);
-                }
-            }
+        // Колбеки програмних таймерів (ефекти, підтвердження, тайм-аути)
+        TimerWheel_Dispatch();
+
+        // Змінені параметри записуються у flash після паузи
+        Settings_Poll();
+
+        // Рядок k виконується, поки переривання вже збирає рядок k+1
+        UartLine *line = UartLink_TakeLine();
+        if (line != NULL) {
+            Dvfs_Boost(); // Потік команд - повна частота
+            Command_Execute(line);
+            UartLink_ReleaseLine(line);
+        } else {
+            // Черги порожні - сон до наступного переривання або таймера
+            Power_Idle();
         }
     }
 }
@@ -161,10 +282,19 @@ void MX_GPIO_Init(void) {
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
     // Увімкнення переривань для PC13
-    HAL_NVIC_SetPriority(EXTI15_10_IRQn, 2, 0);
+    HAL_NVIC_SetPriority(EXTI15_10_IRQn, IRQ_PRIORITY_EXTI, 0);
     HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
 }
 
+void MX_DMA_Init(void) {
+    // Увімкнення тактування DMA1 (USART2_TX - Stream6, канал 4)
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    // Переривання DMA для завершення передачі
+    HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, IRQ_PRIORITY_DMA, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+}
+
 void MX_USART2_UART_Init(void) {
     // Налаштування параметрів UART2
     huart2.Instance = USART2;
@@ -175,9 +305,16 @@ void MX_USART2_UART_Init(void) {
     huart2.Init.Mode = UART_MODE_TX_RX;
     huart2.Init.HwFlowCtl = UART_HWCONTROL_NONE;
     huart2.Init.OverSampling = UART_OVERSAMPLING_16;
+#if BUS_MODE_ENABLED
+    // Пробудження з mute по адресному байту своєї групи
+    if (HAL_MultiProcessor_Init(&huart2, BUS_GROUP_ADDRESS, UART_WAKEUPMETHOD_ADDRESSMARK) != HAL_OK) {
+        Error_Handler();
+    }
+#else
     if (HAL_UART_Init(&huart2) != HAL_OK) {
         Error_Handler();
     }
+#endif
 }
 
 void MX_TIM2_Init(void) {
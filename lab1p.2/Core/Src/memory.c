@@ -0,0 +1,28 @@
+#include "memory.h"
+#include "pool.h"
+
+// Використання RAM за фактичними даними. Reset_Handler заповнює RAM від
+// початку купи (_end) до стека шаблоном MEMORY_PAINT; найнижче слово,
+// яке відрізняється від шаблону, показує найбільшу глибину стека за час
+// роботи. Купа росте назустріч, тож пошук починається від її кінця.
+
+extern uint8_t _end;
+extern uint8_t _estack;
+extern uint32_t _Min_Stack_Size;
+uint8_t *_sbrk_heap_end(uint32_t *failures);
+
+void Memory_GetStats(MemoryStats *stats) {
+    uint32_t *heapEnd = (uint32_t *)(((uint32_t)_sbrk_heap_end(&stats->heapFailures) + 3) & ~3UL);
+    uint32_t *stackTop = (uint32_t *)&_estack;
+    uint32_t *word = heapEnd;
+
+    while (word < stackTop && *word == MEMORY_PAINT) {
+        word++;
+    }
+
+    stats->stackPeak = (uint32_t)stackTop - (uint32_t)word;
+    stats->stackReserved = (uint32_t)&_Min_Stack_Size;
+    stats->heapPeak = (uint32_t)heapEnd - (uint32_t)&_end;
+    stats->heapInUse = Pool_MallocInUse();
+    stats->freeRam = (uint32_t)word - (uint32_t)heapEnd;
+}
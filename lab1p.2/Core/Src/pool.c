@@ -0,0 +1,194 @@
+#include "pool.h"
+#include <errno.h>
+#include <string.h>
+#include <reent.h>
+
+// Пули блоків фіксованого розміру: виділення і звільнення - зняття і
+// повернення голови списку вільних блоків, O(1) і без фрагментації.
+// Список змінюється в короткій критичній секції, тож пул спільний для
+// переривань і головного циклу.
+// Сюди ж направлено malloc newlib: запит отримує блок найменшого
+// класу, що вміщає його; купа _sbrk більше не росте, а вичерпання класу
+// видно в статистиці, а не як фрагментація через тижні роботи.
+// Звільнення чужого вказівника, вказівника в середину блоку чи зайвого
+// блоку (used уже 0) - помилка програми: Error_Handler, а не тихе
+// псування списку вільних блоків.
+
+static Pool *pools; // Усі ініціалізовані пули
+
+void Pool_Init(Pool *pool) {
+    pool->free = NULL;
+    for (int32_t i = pool->blockCount - 1; i >= 0; i--) {
+        PoolBlock *block = (PoolBlock *)&pool->storage[(uint32_t)i * pool->blockSize];
+        block->next = pool->free;
+        pool->free = block;
+    }
+    pool->used = 0;
+    pool->peak = 0;
+    pool->failures = 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    pool->nextPool = pools;
+    pools = pool;
+    __set_PRIMASK(primask);
+}
+
+HOT_FUNC void *Pool_Alloc(Pool *pool) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    PoolBlock *block = pool->free;
+    if (block != NULL) {
+        pool->free = block->next;
+        if (++pool->used > pool->peak) {
+            pool->peak = pool->used;
+        }
+    } else {
+        pool->failures++;
+    }
+    __set_PRIMASK(primask);
+    return block;
+}
+
+void Pool_Free(Pool *pool, void *block) {
+    if (block == NULL) {
+        return;
+    }
+    if (!Pool_Owns(pool, block)) {
+        Error_Handler();
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (pool->used == 0) {
+        Error_Handler(); // Подвійне звільнення
+    }
+    ((PoolBlock *)block)->next = pool->free;
+    pool->free = block;
+    pool->used--;
+    __set_PRIMASK(primask);
+}
+
+// Вказівник на початок одного з блоків пулу
+uint8_t Pool_Owns(const Pool *pool, const void *block) {
+    const uint8_t *address = block;
+    return address >= pool->storage &&
+           address < pool->storage + (uint32_t)pool->blockSize * pool->blockCount &&
+           (uint32_t)(address - pool->storage) % pool->blockSize == 0;
+}
+
+const Pool *Pool_First(void) {
+    return pools;
+}
+
+// Класи розмірів для malloc. Найбільший клас - буфер stdio (BUFSIZ)
+POOL_DEFINE(malloc16, 16, 16);
+POOL_DEFINE(malloc64, 64, 8);
+POOL_DEFINE(malloc256, 256, 4);
+POOL_DEFINE(malloc1024, 1024, 2);
+
+static Pool *const mallocPools[] = { &malloc16, &malloc64, &malloc256, &malloc1024 };
+#define MALLOC_POOLS (sizeof(mallocPools) / sizeof(mallocPools[0]))
+
+static uint8_t mallocReady;
+
+static void Pool_MallocInit(void) {
+    for (uint32_t i = 0; i < MALLOC_POOLS; i++) {
+        Pool_Init(mallocPools[i]);
+    }
+    mallocReady = 1;
+}
+
+static Pool *Pool_Owner(const void *block) {
+    for (uint32_t i = 0; i < MALLOC_POOLS; i++) {
+        if (Pool_Owns(mallocPools[i], block)) {
+            return mallocPools[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t Pool_MallocInUse(void) {
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < MALLOC_POOLS; i++) {
+        bytes += (uint32_t)mallocPools[i]->used * mallocPools[i]->blockSize;
+    }
+    return bytes;
+}
+
+void *_malloc_r(struct _reent *reent, size_t size) {
+    if (!mallocReady) {
+        Pool_MallocInit();
+    }
+    for (uint32_t i = 0; i < MALLOC_POOLS; i++) {
+        if (size <= mallocPools[i]->blockSize) {
+            void *block = Pool_Alloc(mallocPools[i]);
+            if (block != NULL) {
+                return block;
+            }
+        }
+    }
+    reent->_errno = ENOMEM;
+    return NULL;
+}
+
+void _free_r(struct _reent *reent, void *block) {
+    (void)reent;
+    if (block == NULL) {
+        return;
+    }
+    Pool *pool = Pool_Owner(block);
+    if (pool == NULL) {
+        Error_Handler(); // Не з пулів malloc або не початок блоку
+    }
+    Pool_Free(pool, block);
+}
+
+void *_calloc_r(struct _reent *reent, size_t count, size_t size) {
+    size_t total = count * size;
+    if (size != 0 && total / size != count) {
+        reent->_errno = ENOMEM;
+        return NULL;
+    }
+    void *block = _malloc_r(reent, total);
+    if (block != NULL) {
+        memset(block, 0, total);
+    }
+    return block;
+}
+
+void *_realloc_r(struct _reent *reent, void *block, size_t size) {
+    if (block == NULL) {
+        return _malloc_r(reent, size);
+    }
+    Pool *pool = Pool_Owner(block);
+    if (pool == NULL) {
+        // Не наш блок: розмір невідомий, тож і скопіювати його нема як
+        reent->_errno = EINVAL;
+        return NULL;
+    }
+    if (size <= pool->blockSize) {
+        return block; // Блок уже достатній
+    }
+    void *resized = _malloc_r(reent, size);
+    if (resized != NULL) {
+        memcpy(resized, block, pool->blockSize);
+        Pool_Free(pool, block);
+    }
+    return resized;
+}
+
+void *malloc(size_t size) {
+    return _malloc_r(_REENT, size);
+}
+
+void free(void *block) {
+    _free_r(_REENT, block);
+}
+
+void *calloc(size_t count, size_t size) {
+    return _calloc_r(_REENT, count, size);
+}
+
+void *realloc(void *block, size_t size) {
+    return _realloc_r(_REENT, block, size);
+}
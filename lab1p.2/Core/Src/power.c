@@ -0,0 +1,255 @@
+#include "power.h"
+#include "uart_link.h"
+#include "timer_wheel.h"
+
+// Політика простою головного циклу. Звичайний WFI все одно будиться
+// SysTick 1000 разів на секунду, тому, якщо найближчий програмний
+// таймер далеко, SysTick зупиняється, а розбудить ядро пробуджувальний
+// таймер RTC (тактується від LSE 32768 Гц на PC14/PC15). Тривалість сну
+// вимірюється за субсекундами календаря RTC, після чого uwTick і колесо
+// таймерів надолужують пропущені тіки - HAL_GetTick лишається
+// монотонним, а дробові частки мілісекунди переносяться на наступний сон.
+//
+// Якщо світлодіод вимкнено і PWM зупиняти не шкода, замість сну
+// використовується STOP: стабілізатор у режимі низького споживання,
+// flash вимкнено, PLL зупинено. Будять кнопка (EXTI13), старт-біт на
+// PA3 (USART2 RX, EXTI3 лише на час STOP) і той самий таймер RTC.
+// Після виходу ядро працює від HSI, тож PLL із збереженими налаштуваннями
+// SystemClock_Config вмикається напряму регістрами, без HAL_RCC_*.
+// Бюджет пробудження: апаратний вихід (стабілізатор + flash, ~110 мкс
+// за datasheet) плюс захоплення PLL, яке вимірюється тут (POWER).
+// Байт, що розбудив вузол, приймається на неправильній частоті, тому
+// хост перед командою після паузи надсилає '\n' - порожній рядок
+// ігнорується.
+//
+// HAL RTC у проєкті не підключено, тому RTC налаштовується регістрами.
+// LSE запускається кілька сотень мілісекунд; поки він не готовий,
+// простій іде через звичайний WFI.
+
+#define RTC_PREDIV_A      3     // ck_apre = 8192 Гц - роздільність вимірювання сну
+#define RTC_PREDIV_S      8191  // ck_spre = 1 Гц
+#define RTC_SUBSECOND_HZ  8192
+#define RTC_WAKEUP_HZ     2048  // WUCKSEL = RTCCLK/16, до 32 с на один запуск
+#define RTC_DAY           (86400UL * RTC_SUBSECOND_HZ)
+
+#define POWER_RTC_WAIT    0 // Чекаємо на LSE
+#define POWER_RTC_READY   1
+#define POWER_RTC_NONE    2 // RTC вже тактується від іншого джерела
+
+static uint8_t rtcState = POWER_RTC_NONE;
+static uint32_t sleepRemainder = 0; // Залишок, 1/RTC_SUBSECOND_HZ мс
+static volatile PowerStats powerStats;
+
+static inline void Power_RtcUnlock(void) {
+    RTC->WPR = 0xCA;
+    RTC->WPR = 0x53;
+}
+
+static inline void Power_RtcLock(void) {
+    RTC->WPR = 0xFF;
+}
+
+static inline uint32_t Power_Bcd(uint32_t value) {
+    return (value >> 4) * 10 + (value & 0xF);
+}
+
+// Поточний час доби в 1/RTC_SUBSECOND_HZ с. Тіньові регістри вимкнено
+// (BYPSHAD), тому читаємо, доки два зчитування не збіжаться.
+static uint32_t Power_RtcStamp(void) {
+    uint32_t ssr, tr;
+    do {
+        ssr = RTC->SSR;
+        tr = RTC->TR;
+    } while (ssr != RTC->SSR || tr != RTC->TR);
+
+    uint32_t seconds = Power_Bcd((tr >> RTC_TR_SU_Pos) & 0x7F) +
+                       Power_Bcd((tr >> RTC_TR_MNU_Pos) & 0x7F) * 60 +
+                       Power_Bcd((tr >> RTC_TR_HU_Pos) & 0x3F) * 3600;
+    return seconds * RTC_SUBSECOND_HZ + (RTC_PREDIV_S - ssr);
+}
+
+static void Power_RtcInit(void) {
+    if ((RCC->BDCR & RCC_BDCR_RTCSEL) == 0) {
+        RCC->BDCR |= RCC_BDCR_RTCSEL_0; // LSE
+    }
+    RCC->BDCR |= RCC_BDCR_RTCEN;
+
+    Power_RtcUnlock();
+    RTC->ISR |= RTC_ISR_INIT;
+    while (!(RTC->ISR & RTC_ISR_INITF)) {
+    }
+    // Дільники записуються двома окремими звертаннями
+    RTC->PRER = RTC_PREDIV_S;
+    RTC->PRER |= (uint32_t)RTC_PREDIV_A << RTC_PRER_PREDIV_A_Pos;
+    RTC->CR = (RTC->CR & ~(RTC_CR_WUCKSEL | RTC_CR_WUTE | RTC_CR_WUTIE)) | RTC_CR_BYPSHAD;
+    RTC->ISR &= ~RTC_ISR_INIT;
+    Power_RtcLock();
+
+    // Пробудження RTC приходить через лінію EXTI 22
+    EXTI->IMR |= EXTI_IMR_MR22;
+    EXTI->RTSR |= EXTI_RTSR_TR22;
+    HAL_NVIC_SetPriority(RTC_WKUP_IRQn, IRQ_PRIORITY_RTC, 0);
+    HAL_NVIC_EnableIRQ(RTC_WKUP_IRQn);
+
+    rtcState = POWER_RTC_READY;
+}
+
+static uint8_t Power_RtcReady(void) {
+    if (rtcState == POWER_RTC_WAIT && (RCC->BDCR & RCC_BDCR_LSERDY)) {
+        Power_RtcInit();
+    }
+    return rtcState == POWER_RTC_READY;
+}
+
+static void Power_ClearWakeup(void) {
+    RTC->ISR = ~(RTC_ISR_WUTF | RTC_ISR_INIT) | (RTC->ISR & RTC_ISR_INIT);
+    EXTI->PR = EXTI_PR_PR22;
+}
+
+// Запуск пробуджувального таймера на count + 1 тактів RTC_WAKEUP_HZ
+static void Power_RtcArm(uint32_t count) {
+    Power_RtcUnlock();
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    while (!(RTC->ISR & RTC_ISR_WUTWF)) {
+    }
+    RTC->WUTR = count;
+    Power_ClearWakeup();
+    RTC->CR |= RTC_CR_WUTE | RTC_CR_WUTIE;
+    Power_RtcLock();
+}
+
+static void Power_RtcDisarm(void) {
+    Power_RtcUnlock();
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    Power_RtcLock();
+    Power_ClearWakeup();
+    NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+}
+
+// Повернення до джерела SYSCLK, що було до STOP (після виходу - HSI)
+static void Power_RestoreClock(uint32_t source) {
+    if (source != RCC_CFGR_SWS_PLL) {
+        return;
+    }
+    uint32_t start = DWT->CYCCNT;
+    RCC->CR |= RCC_CR_PLLON;
+    while (!(RCC->CR & RCC_CR_PLLRDY)) {
+    }
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+    }
+    // Весь цей час ядро працювало від HSI
+    uint32_t us = (DWT->CYCCNT - start) / (HSI_VALUE / 1000000);
+    powerStats.lastWakeUs = us;
+    if (us > powerStats.maxWakeUs) {
+        powerStats.maxWakeUs = us;
+    }
+}
+
+static void Power_EnterStop(void) {
+    uint32_t source = RCC->CFGR & RCC_CFGR_SWS;
+
+    // Старт-біт на RX будить через EXTI3 (PA3 лишається в режимі AF)
+    EXTI->PR = EXTI_PR_PR3;
+    EXTI->IMR |= EXTI_IMR_MR3;
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+    Power_RestoreClock(source);
+    EXTI->IMR &= ~EXTI_IMR_MR3;
+    EXTI->PR = EXTI_PR_PR3;
+    NVIC_ClearPendingIRQ(EXTI3_IRQn);
+    powerStats.stops++;
+}
+
+// STOP зупиняє таймери і DMA: світлодіод має бути вимкнений, а
+// передача - завершена
+static uint8_t Power_StopAllowed(uint32_t ms) {
+    return POWER_STOP_ENABLED && ms >= POWER_STOP_MIN_MS &&
+           (!ledState || brightness == 0) && UartLink_TxIdle();
+}
+
+// Сон до ms мілісекунд без SysTick; викликається з вимкненими перериваннями
+static void Power_SleepTickless(uint32_t ms) {
+    uint8_t deep = Power_StopAllowed(ms);
+
+    if (ms > POWER_TICKLESS_MAX_MS) {
+        ms = POWER_TICKLESS_MAX_MS;
+    }
+
+    // Частка поточної мілісекунди, яку SysTick уже відрахував
+    uint32_t load = SysTick->LOAD + 1;
+    uint32_t partial = load - 1 - SysTick->VAL;
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    sleepRemainder += (uint64_t)partial * RTC_SUBSECOND_HZ / load;
+
+    // Округлення вниз: прокидаємось не пізніше за дедлайн
+    Power_RtcArm(ms * RTC_WAKEUP_HZ / 1000 - 1);
+    uint32_t start = Power_RtcStamp();
+    if (deep) {
+        Power_EnterStop();
+    } else {
+        __DSB();
+        __WFI(); // Будить RTC або будь-яке інше переривання
+    }
+    powerStats.sleeps++;
+    uint32_t slept = (Power_RtcStamp() + RTC_DAY - start) % RTC_DAY;
+    Power_RtcDisarm();
+
+    sleepRemainder += slept * 1000;
+    uint32_t elapsed = sleepRemainder / RTC_SUBSECOND_HZ;
+    sleepRemainder %= RTC_SUBSECOND_HZ;
+
+    uwTick += elapsed;
+    TimerWheel_Advance(elapsed);
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+}
+
+void Power_Init(void) {
+    if (!POWER_TICKLESS_ENABLED || KERNEL_ENABLED) {
+        return; // Ядро має власну задачу простою
+    }
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    // Не скидаємо backup-домен, якщо RTC уже налаштований на інше джерело
+    uint32_t source = RCC->BDCR & RCC_BDCR_RTCSEL;
+    if (source != 0 && source != RCC_BDCR_RTCSEL_0) {
+        return;
+    }
+    RCC->BDCR |= RCC_BDCR_LSEON;
+    rtcState = POWER_RTC_WAIT;
+
+    if (POWER_STOP_ENABLED) {
+        // Лінія EXTI3 - на PA3; маска вмикається лише на час STOP
+        __HAL_RCC_SYSCFG_CLK_ENABLE();
+        MODIFY_REG(SYSCFG->EXTICR[0], SYSCFG_EXTICR1_EXTI3, SYSCFG_EXTICR1_EXTI3_PA);
+        EXTI->FTSR |= EXTI_FTSR_TR3;
+        HAL_PWREx_EnableFlashPowerDown();
+        HAL_NVIC_SetPriority(EXTI3_IRQn, IRQ_PRIORITY_EXTI, 0);
+        HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+    }
+}
+
+// Простій головного циклу: сон до наступного переривання
+void Power_Idle(void) {
+    __disable_irq();
+    if (!UartLink_Pending() && !TimerWheel_Pending()) {
+        uint32_t idle = TimerWheel_NextExpiry();
+        if (idle >= POWER_TICKLESS_MIN_MS && Power_RtcReady()) {
+            Power_SleepTickless(idle);
+        } else {
+            __WFI();
+        }
+    }
+    __enable_irq();
+}
+
+void Power_WakeupIRQHandler(void) {
+    Power_ClearWakeup();
+}
+
+void Power_GetStats(PowerStats *stats) {
+    __disable_irq();
+    *stats = *(const PowerStats *)&powerStats;
+    __enable_irq();
+}
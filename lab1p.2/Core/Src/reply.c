@@ -0,0 +1,118 @@
+#include "reply.h"
+#include "timer_wheel.h"
+#include "format.h"
+#include <string.h>
+
+// Відповіді на команди з урахуванням режиму. На 9600 бод повна відповідь
+// "Brightness set to NN" (~22 байти) передається довше за саму команду,
+// тому контролер, що шле уставки потоком, може перейти на короткі коди
+// або на тихий режим: кожна команда отримує порядковий номер, а вузол
+// періодично надсилає "A<номер> <бітова маска>", де біт i маски означає
+// помилку команди з номером (номер - i).
+
+static uint8_t replyMode = REPLY_VERBOSE;
+static uint16_t ackSequence = 0;  // Номер останньої виконаної команди
+static uint32_t ackErrors = 0;    // Маска помилок останніх 32 команд
+static uint8_t ackPending = 0;    // Команд після останнього підтвердження
+
+static void Reply_AckTimeout(void *context);
+static Timer ackTimer = { .callback = Reply_AckTimeout };
+
+static void Reply_Send(const UartLine *line, const char *text, uint16_t length) {
+    if (!(line->flags & UART_LINE_NO_REPLY)) {
+        UartLink_Write((const uint8_t *)text, length);
+    }
+}
+
+// Форматований вивід іде прямо в чергу TX
+static void Reply_Put(void *context, char c) {
+    (void)context;
+    UartLink_Put((uint8_t)c);
+}
+
+static void Reply_Ack(void) {
+    Format_Print(Reply_Put, NULL, "A%u %08lX\r\n", ackSequence, ackErrors);
+    UartLink_Flush();
+    ackPending = 0;
+    TimerWheel_Stop(&ackTimer);
+}
+
+// Підтвердження через REPLY_ACK_PERIOD_MS після першої непідтвердженої команди
+static void Reply_AckTimeout(void *context) {
+    (void)context;
+    if (ackPending) {
+        Reply_Ack();
+    }
+}
+
+void Reply_SetMode(uint8_t mode) {
+    if (replyMode == REPLY_SILENT && mode != REPLY_SILENT && ackPending) {
+        Reply_Ack(); // Не губимо вже накопичені підтвердження
+    }
+    replyMode = mode;
+}
+
+uint8_t Reply_GetMode(void) {
+    return replyMode;
+}
+
+// Облік результату; 1 - потрібна повна текстова відповідь
+static uint8_t Reply_Record(const UartLine *line, ReplyCode code) {
+    if (line->flags & UART_LINE_NO_REPLY) {
+        return 0; // Груповий кадр шини не нумерується і не підтверджується
+    }
+    ackSequence++;
+    ackErrors = (ackErrors << 1) | (code != REPLY_OK);
+
+    if (replyMode == REPLY_VERBOSE) {
+        return 1;
+    } else if (replyMode == REPLY_TERSE) {
+        char terse[3] = { (char)('0' + code), '\r', '\n' };
+        Reply_Send(line, terse, sizeof(terse));
+    } else {
+        // На шині вузол не може говорити без запиту, тому там
+        // підтвердження йдуть лише за лічильником
+        if (ackPending++ == 0 && !BUS_MODE_ENABLED) {
+            TimerWheel_Start(&ackTimer, REPLY_ACK_PERIOD_MS, 0);
+        }
+        if (ackPending >= REPLY_ACK_EVERY) {
+            Reply_Ack();
+        }
+    }
+    return 0;
+}
+
+// Результат команди, що змінює стан (уставки)
+void Reply_Result(const UartLine *line, ReplyCode code, const char *text) {
+    if (Reply_Record(line, code)) {
+        Reply_Send(line, text, strlen(text));
+    }
+}
+
+// Те саме з форматуванням; у коротких режимах текст навіть не формується
+void Reply_ResultFormat(const UartLine *line, ReplyCode code, const char *format, ...) {
+    if (Reply_Record(line, code)) {
+        va_list args;
+        va_start(args, format);
+        Format_Vprint(Reply_Put, NULL, format, args);
+        va_end(args);
+        UartLink_Flush();
+    }
+}
+
+// Відповідь на запит (STATS тощо) - надсилається в будь-якому режимі
+void Reply_Text(const UartLine *line, const char *text) {
+    Reply_Send(line, text, strlen(text));
+}
+
+// Форматована відповідь на запит
+void Reply_Format(const UartLine *line, const char *format, ...) {
+    if (line->flags & UART_LINE_NO_REPLY) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    Format_Vprint(Reply_Put, NULL, format, args);
+    va_end(args);
+    UartLink_Flush();
+}
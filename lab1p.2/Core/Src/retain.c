@@ -0,0 +1,59 @@
+#include "retain.h"
+#include "effect.h"
+#include "reply.h"
+
+// Стан, що переживає скидання без читання flash. Яскравість, стан
+// світлодіода і режим відповідей дублюються в резервному регістрі RTC
+// BKP0R при кожній зміні (Settings_Poll) - він зберігається і при
+// скиданні, і в STANDBY. Позиція ефекту лежить у секції .noinit, яку
+// стартовий код не обнуляє; вона дійсна лише після теплого скидання,
+// тобто без прапорців POR/BOR у RCC_CSR. Під час ефекту в регістр
+// іде кінцева яскравість (Effect_Target), інакше тепле скидання посеред
+// ефекту закріпило б проміжну.
+// Формат BKP0R: [31:16] мітка, [9:8] режим відповідей,
+// [7] світлодіод, [6:0] яскравість.
+
+#define RETAIN_MAGIC       0xB1A5UL
+#define RETAIN_MAGIC_SHIFT 16
+
+static uint8_t warmReset;
+
+// До будь-якої ініціалізації периферії: прапорці скидання і доступ
+// до backup-домену
+void Retain_Init(void) {
+    warmReset = !__HAL_RCC_GET_FLAG(RCC_FLAG_PORRST) && !__HAL_RCC_GET_FLAG(RCC_FLAG_BORRST);
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+}
+
+// Живлення не зникало, вміст .noinit дійсний
+uint8_t Retain_IsWarm(void) {
+    return warmReset;
+}
+
+// Відновлення з резервного регістра; 0 - регістр порожній
+uint8_t Retain_Restore(void) {
+    uint32_t saved = RTC->BKP0R;
+
+    if ((saved >> RETAIN_MAGIC_SHIFT) != RETAIN_MAGIC) {
+        return 0;
+    }
+    uint8_t level = saved & 0x7F;
+    uint8_t mode = (saved >> 8) & 0x3;
+    if (level > 99 || mode > REPLY_VERBOSE) {
+        return 0;
+    }
+    brightness = level;
+    ledState = (saved >> 7) & 1;
+    Reply_SetMode(mode);
+    if (warmReset) {
+        Effect_Resume(); // Ефект продовжується з тієї ж позиції
+    }
+    return 1;
+}
+
+void Retain_Save(void) {
+    RTC->BKP0R = (RETAIN_MAGIC << RETAIN_MAGIC_SHIFT) | ((uint32_t)Reply_GetMode() << 8) |
+                 ((uint32_t)(ledState & 1) << 7) | (Effect_Target() & 0x7F);
+}
@@ -0,0 +1,276 @@
+#include "settings.h"
+#include "timer_wheel.h"
+#include "effect.h"
+#include "reply.h"
+#include "retain.h"
+
+// Журнал параметрів у секторі 7. Сектор починається словом-міткою,
+// далі записи по три слова: ключ, значення, CRC32 обох (апаратний блок
+// CRC). Зміна параметра - дописування нового запису в кінець, тобто
+// O(1) і без стирання; при відновленні перемагає останній запис ключа.
+// CRC пишеться останнім, тож запис, перерваний вимкненням живлення,
+// просто відкидається. Сектор стирається лише тоді, коли журнал
+// заповнено: актуальні значення з RAM переписуються на початок.
+// Під час запису і стирання ядро стоїть на вибірці з flash (один
+// банк); слово пишеться ~16 мкс, стирання 128 КБ триває 1-2 с і
+// трапляється раз на ~10900 змін. Сектор один, тож вимкнення живлення
+// саме під час стискання повертає параметри до типових. Чистий сектор
+// (перше ввімкнення після прошивки) не стирається - лише отримує мітку,
+// тож старт, зокрема BOOT_FAST, не чекає на стирання.
+// Збій запису не зупиняє вузол: запис переноситься в наступну комірку
+// (до SETTINGS_ATTEMPTS спроб), а зіпсована комірка читається як запис
+// з помилкою CRC. Невдале стирання лишає журнал "заповненим" - значення
+// живуть у RAM, і наступна зміна пробує стерти сектор знову.
+
+#define SETTINGS_MAGIC        0x4B565331UL // "KVS1"
+#define SETTINGS_RECORD_WORDS 3
+#define SETTINGS_RECORD_SIZE  (SETTINGS_RECORD_WORDS * 4)
+#define SETTINGS_FIRST        (SETTINGS_ADDRESS + 4)
+#define SETTINGS_END          (SETTINGS_ADDRESS + SETTINGS_SIZE)
+#define SETTINGS_ERASED       0xFFFFFFFFUL
+#define SETTINGS_ATTEMPTS     3 // Спроб дописати запис, кожна в нову комірку
+#define SETTINGS_FLASH_ERRORS (FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
+                               FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+typedef struct {
+    uint16_t key;
+    uint32_t value;
+} SettingsEntry;
+
+static SettingsEntry entries[SETTINGS_MAX_KEYS]; // Актуальні значення
+static uint8_t entryCount;
+static uint8_t loaded;        // Журнал прочитано
+static uint32_t writeAddress; // Наступний вільний запис
+static SettingsStats settingsStats;
+
+static void Settings_SaveTimeout(void *context);
+static Timer saveTimer = { .callback = Settings_SaveTimeout };
+static uint8_t seenBrightness;  // Значення на попередньому Settings_Poll
+static uint8_t seenLedState;
+static uint8_t seenReplyMode;
+
+static uint32_t Settings_Crc(uint32_t key, uint32_t value) {
+    CRC->CR = CRC_CR_RESET;
+    CRC->DR = key;
+    CRC->DR = value;
+    return CRC->DR;
+}
+
+static SettingsEntry *Settings_Find(uint16_t key) {
+    for (uint8_t i = 0; i < entryCount; i++) {
+        if (entries[i].key == key) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void Settings_Remember(uint16_t key, uint32_t value) {
+    SettingsEntry *entry = Settings_Find(key);
+    if (entry == NULL) {
+        if (entryCount >= SETTINGS_MAX_KEYS) {
+            return;
+        }
+        entry = &entries[entryCount++];
+        entry->key = key;
+    }
+    entry->value = value;
+}
+
+// Запис слова; після збою прапорці помилок скидаються, інакше
+// контролер flash відкидатиме й наступні операції
+static uint8_t Settings_Program(uint32_t address, uint32_t word) {
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word) == HAL_OK) {
+        return 1;
+    }
+    __HAL_FLASH_CLEAR_FLAG(SETTINGS_FLASH_ERRORS);
+    settingsStats.failures++;
+    return 0;
+}
+
+// 0 - запис не вдався жодного разу або журнал заповнено
+static uint8_t Settings_Append(uint16_t key, uint32_t value) {
+    for (uint8_t attempt = 0; attempt < SETTINGS_ATTEMPTS; attempt++) {
+        if (writeAddress + SETTINGS_RECORD_SIZE > SETTINGS_END) {
+            return 0;
+        }
+        uint32_t address = writeAddress;
+        writeAddress += SETTINGS_RECORD_SIZE;
+        settingsStats.records++;
+        if (Settings_Program(address, key) && Settings_Program(address + 4, value) &&
+            Settings_Program(address + 8, Settings_Crc(key, value))) {
+            return 1;
+        }
+        // Комірка могла лишитися стертою - тоді Settings_Load прийняв би
+        // її за кінець журналу. Нуль у ключі робить її просто зіпсованою
+        Settings_Program(address, 0);
+    }
+    return 0;
+}
+
+// Стирання сектора і запис мітки; значення лишаються лише в RAM.
+// 0 - сектор не підготовлено, дописування вимкнено до наступної спроби
+static uint8_t Settings_Format(void) {
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_SECTORS,
+        .Sector = SETTINGS_SECTOR,
+        .NbSectors = 1,
+        .VoltageRange = FLASH_VOLTAGE_RANGE_3
+    };
+    uint32_t sectorError;
+
+    writeAddress = SETTINGS_END;
+    settingsStats.records = 0;
+    if (HAL_FLASHEx_Erase(&erase, &sectorError) != HAL_OK) {
+        __HAL_FLASH_CLEAR_FLAG(SETTINGS_FLASH_ERRORS);
+        settingsStats.failures++;
+        return 0;
+    }
+    settingsStats.erases++;
+    if (!Settings_Program(SETTINGS_ADDRESS, SETTINGS_MAGIC)) {
+        return 0;
+    }
+    writeAddress = SETTINGS_FIRST;
+    return 1;
+}
+
+// Сектор повністю стертий: читання 128 КБ - кілька мс проти 1-2 с стирання
+static uint8_t Settings_Blank(void) {
+    for (uint32_t address = SETTINGS_ADDRESS; address < SETTINGS_END; address += 4) {
+        if (*(const uint32_t *)address != SETTINGS_ERASED) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void Settings_Init(void) {
+    __HAL_RCC_CRC_CLK_ENABLE();
+    loaded = 0;
+}
+
+// Читання журналу: останній коректний запис кожного ключа. Виконується
+// при першому зверненні, тож тепле скидання без змін його не потребує
+static void Settings_Load(void) {
+    loaded = 1;
+    entryCount = 0;
+
+    if (*(const uint32_t *)SETTINGS_ADDRESS != SETTINGS_MAGIC) {
+        HAL_FLASH_Unlock();
+        if (!Settings_Blank()) {
+            Settings_Format(); // Чужі або зіпсовані дані
+        } else if (Settings_Program(SETTINGS_ADDRESS, SETTINGS_MAGIC)) {
+            writeAddress = SETTINGS_FIRST;
+        } else {
+            writeAddress = SETTINGS_END;
+        }
+        HAL_FLASH_Lock();
+        return;
+    }
+    uint32_t address = SETTINGS_FIRST;
+    while (address + SETTINGS_RECORD_SIZE <= SETTINGS_END) {
+        const uint32_t *record = (const uint32_t *)address;
+        if (record[0] == SETTINGS_ERASED && record[1] == SETTINGS_ERASED &&
+            record[2] == SETTINGS_ERASED) {
+            break; // Кінець журналу
+        }
+        if (record[0] <= 0xFFFF && record[2] == Settings_Crc(record[0], record[1])) {
+            Settings_Remember((uint16_t)record[0], record[1]);
+        } else {
+            settingsStats.corrupted++;
+        }
+        address += SETTINGS_RECORD_SIZE;
+        settingsStats.records++;
+    }
+    writeAddress = address;
+}
+
+uint8_t Settings_Get(uint16_t key, uint32_t *value) {
+    if (!loaded) {
+        Settings_Load();
+    }
+    const SettingsEntry *entry = Settings_Find(key);
+    if (entry == NULL) {
+        return 0;
+    }
+    *value = entry->value;
+    return 1;
+}
+
+// Запис лише зміненого значення
+void Settings_Put(uint16_t key, uint32_t value) {
+    uint32_t stored;
+    if (Settings_Get(key, &stored) && stored == value) {
+        return;
+    }
+    Settings_Remember(key, value);
+
+    HAL_FLASH_Unlock();
+    if (writeAddress + SETTINGS_RECORD_SIZE > SETTINGS_END) {
+        // Журнал заповнено: стискаємо до одного запису на ключ
+        if (Settings_Format()) {
+            for (uint8_t i = 0; i < entryCount; i++) {
+                Settings_Append(entries[i].key, entries[i].value);
+            }
+        }
+    } else {
+        Settings_Append(key, value);
+    }
+    HAL_FLASH_Lock();
+}
+
+// Застосування збережених параметрів прошивки (до запуску PWM): з
+// резервного регістра, якщо він заповнений, інакше з журналу
+void Settings_Restore(void) {
+    uint32_t value;
+
+    if (!Retain_Restore()) {
+        if (Settings_Get(SETTINGS_KEY_BRIGHTNESS, &value) && value <= 99) {
+            brightness = value;
+        }
+        if (Settings_Get(SETTINGS_KEY_LED_STATE, &value) && value <= 1) {
+            ledState = value;
+        }
+        if (Settings_Get(SETTINGS_KEY_REPLY_MODE, &value) && value <= REPLY_VERBOSE) {
+            Reply_SetMode(value);
+        }
+        Retain_Save();
+    }
+    seenBrightness = Effect_Target();
+    seenLedState = ledState;
+    seenReplyMode = Reply_GetMode();
+}
+
+static void Settings_SaveTimeout(void *context) {
+    (void)context;
+    if (Effect_IsRunning()) {
+        // Зберігаємо кінцеву яскравість, а не проміжну
+        TimerWheel_Start(&saveTimer, SETTINGS_SAVE_DELAY_MS, 0);
+        return;
+    }
+    Settings_Put(SETTINGS_KEY_BRIGHTNESS, brightness);
+    Settings_Put(SETTINGS_KEY_LED_STATE, ledState);
+    Settings_Put(SETTINGS_KEY_REPLY_MODE, Reply_GetMode());
+}
+
+// З головного циклу: зміна параметрів відкладає запис на
+// SETTINGS_SAVE_DELAY_MS, тож потік уставок не зношує flash
+void Settings_Poll(void) {
+    uint8_t level = Effect_Target(); // Кроки ефекту не перезаписують BKP0R
+    uint8_t replyMode = Reply_GetMode();
+    if (level != seenBrightness || ledState != seenLedState || replyMode != seenReplyMode) {
+        seenBrightness = level;
+        seenLedState = ledState;
+        seenReplyMode = replyMode;
+        Retain_Save(); // Резервний регістр - одразу, flash - після паузи
+        TimerWheel_Start(&saveTimer, SETTINGS_SAVE_DELAY_MS, 0);
+    }
+}
+
+void Settings_GetStats(SettingsStats *stats) {
+    if (!loaded) {
+        Settings_Load();
+    }
+    *stats = settingsStats;
+    stats->free = (SETTINGS_END - writeAddress) / SETTINGS_RECORD_SIZE;
+}
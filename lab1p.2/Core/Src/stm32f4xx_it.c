@@ -22,6 +22,11 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "timer_wheel.h"
+#include "kernel.h"
+#include "power.h"
+#include "deferred.h"
+#include "isr_monitor.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -55,6 +60,8 @@
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_usart2_tx;
+extern UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN EV */
 
@@ -77,8 +84,11 @@ void NMI_Handler(void)
   }
   /* USER CODE END NonMaskableInt_IRQn 1 */
 }
-void EXTI15_10_IRQHandler(void) {
+HOT_FUNC void EXTI15_10_IRQHandler(void) {
+    IsrFrame frame;
+    IsrMonitor_Enter(&frame);
     HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13); // Виклик обробника HAL
+    IsrMonitor_Exit(&frame, ISR_MONITOR_BUTTON, ISR_MONITOR_NO_LATENCY);
 }
 
 /**
@@ -167,29 +177,42 @@ void DebugMon_Handler(void)
   /* USER CODE END DebugMonitor_IRQn 1 */
 }
 
+#if !KERNEL_ENABLED
+/* With the kernel enabled PendSV_Handler is the context switch in kernel.c */
 /**
   * @brief This function handles Pendable request for system service.
   */
 void PendSV_Handler(void)
 {
   /* USER CODE BEGIN PendSV_IRQn 0 */
+  Deferred_Drain();
 
   /* USER CODE END PendSV_IRQn 0 */
   /* USER CODE BEGIN PendSV_IRQn 1 */
 
   /* USER CODE END PendSV_IRQn 1 */
 }
+#endif
 
 /**
   * @brief This function handles System tick timer.
   */
-void SysTick_Handler(void)
+HOT_FUNC void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
+  // Тактів від перезавантаження лічильника до входу в обробник
+  uint32_t latency = SysTick->LOAD - SysTick->VAL;
+  IsrFrame frame;
+  IsrMonitor_Enter(&frame);
 
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  TimerWheel_Tick();
+#if KERNEL_ENABLED
+  Kernel_Tick();
+#endif
+  IsrMonitor_Exit(&frame, ISR_MONITOR_TICK, latency);
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -201,6 +224,71 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32f4xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles DMA1 stream6 global interrupt.
+  */
+HOT_FUNC void DMA1_Stream6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 0 */
+  IsrFrame frame;
+  IsrMonitor_Enter(&frame);
+
+  /* USER CODE END DMA1_Stream6_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 1 */
+  IsrMonitor_Exit(&frame, ISR_MONITOR_DMA, ISR_MONITOR_NO_LATENCY);
+
+  /* USER CODE END DMA1_Stream6_IRQn 1 */
+}
+
+/**
+  * @brief This function handles USART2 global interrupt.
+  */
+HOT_FUNC void USART2_IRQHandler(void)
+{
+  /* USER CODE BEGIN USART2_IRQn 0 */
+  IsrFrame frame;
+  IsrMonitor_Enter(&frame);
+
+  /* USER CODE END USART2_IRQn 0 */
+  HAL_UART_IRQHandler(&huart2);
+  /* USER CODE BEGIN USART2_IRQn 1 */
+  IsrMonitor_Exit(&frame, ISR_MONITOR_UART, ISR_MONITOR_NO_LATENCY);
+
+  /* USER CODE END USART2_IRQn 1 */
+}
+
+/**
+  * @brief This function handles EXTI line3 interrupt.
+  */
+void EXTI3_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI3_IRQn 0 */
+
+  /* USER CODE END EXTI3_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_3);
+  /* USER CODE BEGIN EXTI3_IRQn 1 */
+
+  /* USER CODE END EXTI3_IRQn 1 */
+}
+
+/**
+  * @brief This function handles RTC wake-up interrupt through EXTI line 22.
+  */
+void RTC_WKUP_IRQHandler(void)
+{
+  /* USER CODE BEGIN RTC_WKUP_IRQn 0 */
+  IsrFrame frame;
+  IsrMonitor_Enter(&frame);
+
+  /* USER CODE END RTC_WKUP_IRQn 0 */
+  Power_WakeupIRQHandler();
+  /* USER CODE BEGIN RTC_WKUP_IRQn 1 */
+  IsrMonitor_Exit(&frame, ISR_MONITOR_WAKE, ISR_MONITOR_NO_LATENCY);
+
+  /* USER CODE END RTC_WKUP_IRQn 1 */
+}
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
@@ -29,6 +29,11 @@
  */
 static uint8_t *__sbrk_heap_end = NULL;
 
+/**
+ * Number of _sbrk calls refused because the heap would reach the stack
+ */
+static uint32_t __sbrk_failures = 0;
+
 /**
  * @brief _sbrk() allocates memory to the newlib heap and is used by malloc
  *        and others from the C library
@@ -68,6 +73,7 @@ void *_sbrk(ptrdiff_t incr)
   /* Protect heap from growing into the reserved MSP stack */
   if (__sbrk_heap_end + incr > max_heap)
   {
+    __sbrk_failures++;
     errno = ENOMEM;
     return (void *)-1;
   }
@@ -77,3 +83,19 @@ void *_sbrk(ptrdiff_t incr)
 
   return (void *)prev_heap_end;
 }
+
+/**
+ * @brief Reports the heap high watermark for the MEM command. The newlib
+ *        heap never returns memory to _sbrk, so the current end is also
+ *        the peak.
+ *
+ * @param failures Number of refused _sbrk calls
+ * @return Current end of the heap
+ */
+uint8_t *_sbrk_heap_end(uint32_t *failures)
+{
+  extern uint8_t _end; /* Symbol defined in the linker script */
+
+  *failures = __sbrk_failures;
+  return (NULL == __sbrk_heap_end) ? &_end : __sbrk_heap_end;
+}
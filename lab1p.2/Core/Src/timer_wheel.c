@@ -0,0 +1,216 @@
+#include "timer_wheel.h"
+
+// Ієрархічне колесо таймерів (4 рівні по 64 слоти, крок 1 мс). Рівень 0
+// покриває найближчі 64 мс, кожен наступний - у 64 рази більший інтервал,
+// разом - 2^24 мс (~4.6 год); довші затримки переставляються повторно.
+// Вставка і зупинка - O(1): таймер додається на початок списку слота і
+// вилучається через вказівник на попереднє посилання. SysTick лише
+// переносить таймери, що спрацювали, у чергу; колбеки викликаються з
+// головного циклу в TimerWheel_Dispatch.
+
+#define WHEEL_BITS       6
+#define WHEEL_SLOTS      (1UL << WHEEL_BITS)
+#define WHEEL_MASK       (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS     4
+#define WHEEL_MAX_DELAY  ((1UL << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+static Timer *wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static Timer *expiredHead = NULL;           // Черга таймерів на виконання
+static Timer **expiredTail = &expiredHead;
+static volatile uint32_t wheelNow = 0;      // Останній оброблений тік
+
+// Таймери змінюються і з переривань, і з головного циклу
+static inline uint32_t TimerWheel_Lock(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static inline void TimerWheel_Unlock(uint32_t primask) {
+    __set_PRIMASK(primask);
+}
+
+static void TimerWheel_Push(Timer **head, Timer *timer) {
+    timer->next = *head;
+    if (*head != NULL) {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void TimerWheel_Expire(Timer *timer) {
+    timer->next = NULL;
+    timer->pprev = expiredTail;
+    *expiredTail = timer;
+    expiredTail = &timer->next;
+}
+
+static void TimerWheel_Unlink(Timer *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    } else if (expiredTail == &timer->next) {
+        expiredTail = timer->pprev;
+    }
+    timer->pprev = NULL;
+}
+
+static void TimerWheel_Insert(Timer *timer) {
+    uint32_t delta = timer->expires - wheelNow;
+    uint8_t level = 0;
+
+    if ((int32_t)delta <= 0) {
+        TimerWheel_Expire(timer);
+        return;
+    }
+    if (delta > WHEEL_MAX_DELAY) {
+        delta = WHEEL_MAX_DELAY; // Дочекається на останньому рівні
+    }
+    while (delta >= (1UL << (WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    uint32_t slot = ((wheelNow + delta) >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    TimerWheel_Push(&wheel[level][slot], timer);
+}
+
+// Переставляє таймери слота старшого рівня на нижчі рівні
+static void TimerWheel_Cascade(uint8_t level, uint32_t slot) {
+    Timer *timer = wheel[level][slot];
+    wheel[level][slot] = NULL;
+    while (timer != NULL) {
+        Timer *next = timer->next;
+        TimerWheel_Insert(timer);
+        timer = next;
+    }
+}
+
+void TimerWheel_InitTimer(Timer *timer, TimerCallback callback, void *context) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->period = 0;
+    timer->callback = callback;
+    timer->context = context;
+}
+
+// Запуск (або перезапуск) через delay мс, далі кожні period мс
+void TimerWheel_Start(Timer *timer, uint32_t delay, uint32_t period) {
+    uint32_t primask = TimerWheel_Lock();
+    if (timer->pprev != NULL) {
+        TimerWheel_Unlink(timer);
+    }
+    timer->expires = wheelNow + delay;
+    timer->period = period;
+    TimerWheel_Insert(timer);
+    TimerWheel_Unlock(primask);
+}
+
+void TimerWheel_Stop(Timer *timer) {
+    uint32_t primask = TimerWheel_Lock();
+    if (timer->pprev != NULL) {
+        TimerWheel_Unlink(timer);
+    }
+    TimerWheel_Unlock(primask);
+}
+
+uint8_t TimerWheel_IsActive(const Timer *timer) {
+    return timer->pprev != NULL;
+}
+
+// Викликається з SysTick_Handler кожну мілісекунду
+HOT_FUNC void TimerWheel_Tick(void) {
+    uint32_t now = ++wheelNow;
+    uint32_t index = now & WHEEL_MASK;
+
+    if (index == 0) {
+        for (uint8_t level = 1; level < WHEEL_LEVELS; level++) {
+            uint32_t slot = (now >> (WHEEL_BITS * level)) & WHEEL_MASK;
+            TimerWheel_Cascade(level, slot);
+            if (slot != 0) {
+                break;
+            }
+        }
+    }
+
+    Timer *timer = wheel[0][index];
+    wheel[0][index] = NULL;
+    while (timer != NULL) {
+        Timer *next = timer->next;
+        TimerWheel_Expire(timer);
+        timer = next;
+    }
+    if (expiredHead != NULL) {
+        TimerWheel_ExpiredCallback();
+    }
+}
+
+// Є таймери на виконання; викликається з SysTick. Перевизначається,
+// якщо TimerWheel_Dispatch працює не в головному циклі.
+__weak void TimerWheel_ExpiredCallback(void) {
+}
+
+// Виконання колбеків таймерів, що спрацювали (головний цикл)
+void TimerWheel_Dispatch(void) {
+    while (1) {
+        uint32_t primask = TimerWheel_Lock();
+        Timer *timer = expiredHead;
+        if (timer == NULL) {
+            TimerWheel_Unlock(primask);
+            return;
+        }
+        TimerWheel_Unlink(timer);
+        if (timer->period != 0) {
+            timer->expires += timer->period; // Без накопичення похибки
+            TimerWheel_Insert(timer);
+        }
+        TimerWheel_Unlock(primask);
+
+        if (timer->callback != NULL) {
+            timer->callback(timer->context);
+        }
+    }
+}
+
+uint8_t TimerWheel_Pending(void) {
+    return expiredHead != NULL;
+}
+
+// Мілісекунд до найближчого спрацювання (0 - вже є що виконувати,
+// TIMER_WHEEL_NEVER - активних таймерів немає). Обходить усі слоти,
+// тож викликається лише перед сном, а не в кожному тіку.
+uint32_t TimerWheel_NextExpiry(void) {
+    uint32_t primask = TimerWheel_Lock();
+    uint32_t nearest = TIMER_WHEEL_NEVER;
+
+    if (expiredHead != NULL) {
+        nearest = 0;
+    } else {
+        for (uint8_t level = 0; level < WHEEL_LEVELS; level++) {
+            for (uint32_t slot = 0; slot < WHEEL_SLOTS; slot++) {
+                for (Timer *timer = wheel[level][slot]; timer != NULL; timer = timer->next) {
+                    uint32_t delta = timer->expires - wheelNow;
+                    if (delta < nearest) {
+                        nearest = delta;
+                    }
+                }
+            }
+        }
+    }
+    TimerWheel_Unlock(primask);
+    return nearest;
+}
+
+// Надолужує ticks пропущених тіків після сну без SysTick.
+// Порожні слоти рівня 0 проходяться без розбору списків.
+void TimerWheel_Advance(uint32_t ticks) {
+    uint32_t primask = TimerWheel_Lock();
+    while (ticks-- > 0) {
+        uint32_t index = (wheelNow + 1) & WHEEL_MASK;
+        if (index != 0 && wheel[0][index] == NULL) {
+            wheelNow++;
+        } else {
+            TimerWheel_Tick();
+        }
+    }
+    TimerWheel_Unlock(primask);
+}
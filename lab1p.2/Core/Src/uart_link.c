@@ -0,0 +1,306 @@
+#include "uart_link.h"
+#include "bus.h"
+#include "pool.h"
+#include "vectors.h"
+#include "isr_monitor.h"
+
+// Прийом USART2 по перериваннях з конвеєром рядкових буферів: переривання
+// збирає рядок k+1, поки головний цикл виконує рядок k. Буфери не
+// копіюються: вільні беруться з пулу, готові передаються циклу
+// вказівниками через чергу з одним записувачем і одним читачем. Помилки лінії рахуються в
+// HAL_UART_ErrorCallback, після чого прийом одразу перезапускається.
+//
+// З таблицею векторів у SRAM чистий прийом байта обходить HAL: власний
+// обробник читає DR і одразу додає байт до рядка.
+//
+// Передача не блокує головний цикл: відповіді копіюються в кільцеву
+// чергу, яку DMA вивантажує суцільними шматками у фоні.
+
+#define LINE_QUEUE_SIZE 8   // Степінь двійки, більше за UART_LINE_COUNT
+#define TX_RING_SIZE    256 // Степінь двійки
+
+#define UART_SR_ERRORS  (USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_PE)
+
+typedef struct {
+    UartLine *slot[LINE_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+} LineQueue;
+
+static UART_HandleTypeDef *linkUart = NULL;
+static uint8_t rxByte;                     // Байт, який приймає HAL
+POOL_DEFINE(linePool, sizeof(UartLine), UART_LINE_COUNT);
+static LineQueue readyLines;               // Переривання -> головний цикл
+static UartLine *fillLine;                 // Буфер, який зараз заповнюється
+static uint8_t frameSkipped = 0;           // Кадр шини іншого вузла
+static uint8_t frameFlags = 0;             // Ознаки поточного кадру шини
+static volatile UartLinkStats linkStats;
+
+static uint8_t txRing[TX_RING_SIZE];
+static volatile uint16_t txHead = 0;       // Пише головний цикл
+static volatile uint16_t txTail = 0;       // Звільняє переривання DMA
+static volatile uint16_t txChunk = 0;      // Довжина шматка, що передається
+static volatile uint8_t txBusy = 0;
+
+#if VECTORS_RAM_ENABLED
+static void UartLink_IRQHandler(void);
+#endif
+
+static HOT_FUNC void LineQueue_Put(LineQueue *queue, UartLine *line) {
+    queue->slot[queue->head] = line;
+    queue->head = (queue->head + 1) & (LINE_QUEUE_SIZE - 1);
+}
+
+static UartLine *LineQueue_Get(LineQueue *queue) {
+    uint8_t tail = queue->tail;
+    if (tail == queue->head) {
+        return NULL;
+    }
+    UartLine *line = queue->slot[tail];
+    queue->tail = (tail + 1) & (LINE_QUEUE_SIZE - 1);
+    return line;
+}
+
+static HOT_FUNC void UartLink_Arm(void) {
+    if (HAL_UART_Receive_IT(linkUart, &rxByte, 1) != HAL_OK) {
+        linkStats.rearmFailures++;
+    }
+}
+
+static HOT_FUNC void UartLink_ResetFill(void) {
+    fillLine->length = 0;
+    fillLine->flags = frameFlags;
+}
+
+void UartLink_Start(UART_HandleTypeDef *huart) {
+    linkUart = huart;
+    Pool_Init(&linePool);
+    fillLine = Pool_Alloc(&linePool);
+    UartLink_ResetFill();
+    UartLink_Arm();
+#if VECTORS_RAM_ENABLED
+    if (huart->Instance == USART2) {
+        Vectors_Install(USART2_IRQn, UartLink_IRQHandler);
+    }
+#endif
+}
+
+// Забирає наступний прийнятий рядок; NULL - черга порожня
+UartLine *UartLink_TakeLine(void) {
+    return LineQueue_Get(&readyLines);
+}
+
+// Повертає оброблений буфер перериванню
+void UartLink_ReleaseLine(UartLine *line) {
+    Pool_Free(&linePool, line);
+}
+
+uint8_t UartLink_Pending(void) {
+    return readyLines.tail != readyLines.head;
+}
+
+// Черга передачі порожня і останній байт уже вийшов на лінію
+uint8_t UartLink_TxIdle(void) {
+    return !txBusy && txHead == txTail;
+}
+
+// Приймач мовчить: після останнього байта лінія простояла цілий кадр
+// (IDLE) і непрочитаного байта немає. IDLE скидається читанням SR і DR
+// в обробнику прийому, тож до першого байта він може бути не
+// встановлений - тоді достатньо порожнього DR. Старт-біт, що прийшов
+// уже після IDLE, так не видно; вікно - кілька тактів до перемикання.
+uint8_t UartLink_RxIdle(void) {
+    if (linkUart == NULL) {
+        return 1;
+    }
+    uint32_t status = linkUart->Instance->SR;
+    if (status & USART_SR_RXNE) {
+        return 0;
+    }
+    return (status & USART_SR_IDLE) || linkStats.rxBytes == 0;
+}
+
+// Запуск DMA на наступний суцільний шматок черги.
+// Викликається з переривання або з вимкненими перериваннями.
+static HOT_FUNC void UartLink_Kick(void) {
+    uint16_t tail = txTail;
+    uint16_t head = txHead;
+
+    if (txBusy || tail == head) {
+        return;
+    }
+    txChunk = (head > tail) ? (head - tail) : (TX_RING_SIZE - tail);
+    txBusy = 1;
+    if (HAL_UART_Transmit_DMA(linkUart, &txRing[tail], txChunk) != HAL_OK) {
+        txBusy = 0;
+    }
+}
+
+// Ставить дані в чергу передачі; чекає лише тоді, коли черга повна
+void UartLink_Write(const uint8_t *data, uint16_t length) {
+    uint8_t stalled = 0;
+
+    linkStats.txBytes += length;
+    while (length > 0) {
+        uint16_t head = txHead;
+        uint16_t space = (txTail - head - 1) & (TX_RING_SIZE - 1);
+        if (space == 0) {
+            stalled = 1;
+            continue; // DMA звільнить місце
+        }
+        uint16_t count = (length < space) ? length : space;
+        for (uint16_t i = 0; i < count; i++) {
+            txRing[(head + i) & (TX_RING_SIZE - 1)] = data[i];
+        }
+        txHead = (head + count) & (TX_RING_SIZE - 1);
+        data += count;
+        length -= count;
+
+        __disable_irq();
+        UartLink_Kick();
+        __enable_irq();
+    }
+    if (stalled) {
+        linkStats.txStalls++;
+    }
+}
+
+// Рядок поставлено в чергу; викликається з переривання. Перевизначається,
+// якщо рядки забирає задача ядра, а не головний цикл.
+__weak void UartLink_LineCallback(void) {
+}
+
+// Один байт у чергу без запуску DMA (форматований вивід); передачу
+// запускає UartLink_Flush, або сама черга, коли вона заповнена
+void UartLink_Put(uint8_t byte) {
+    uint16_t head = txHead;
+
+    if (((txTail - head - 1) & (TX_RING_SIZE - 1)) == 0) {
+        linkStats.txStalls++;
+        UartLink_Flush();
+        while (((txTail - head - 1) & (TX_RING_SIZE - 1)) == 0) {
+            // DMA звільнить місце
+        }
+    }
+    txRing[head] = byte;
+    txHead = (head + 1) & (TX_RING_SIZE - 1);
+    linkStats.txBytes++;
+}
+
+void UartLink_Flush(void) {
+    __disable_irq();
+    UartLink_Kick();
+    __enable_irq();
+}
+
+void UartLink_GetStats(UartLinkStats *stats) {
+    __disable_irq();
+    *stats = *(const UartLinkStats *)&linkStats;
+    __enable_irq();
+}
+
+// Завершення рядка: передача буфера циклу і взяття вільного
+static HOT_FUNC void UartLink_CompleteLine(void) {
+    UartLine *line = fillLine;
+    UartLine *next;
+
+    if (line->length == 0 && !(line->flags & UART_LINE_OVERFLOW)) {
+        return; // Порожній рядок (наприклад, '\n' після '\r')
+    }
+    line->data[line->length] = '\0';
+    if ((next = Pool_Alloc(&linePool)) != NULL) {
+        LineQueue_Put(&readyLines, fillLine);
+        fillLine = next;
+        UartLink_LineCallback();
+    } else {
+        linkStats.dropped++; // Цикл не встигає - буфер перезаписується
+    }
+    UartLink_ResetFill();
+    Bus_EndFrame();
+}
+
+// Прийнятий байт: адреса шини, кінець рядка або черговий символ
+static HOT_FUNC void UartLink_Receive(uint8_t data) {
+    UartLine *line = fillLine;
+
+    linkStats.rxBytes++;
+    if (Bus_IsAddressByte(data)) {
+        // Початок нового кадру на шині: чужий кадр повертає приймач у mute
+        uint8_t frame = Bus_SelectFrame(data);
+        frameSkipped = (frame == BUS_FRAME_NONE);
+        frameFlags = (frame == BUS_FRAME_GROUP) ? UART_LINE_NO_REPLY : 0;
+        UartLink_ResetFill();
+    } else if (frameSkipped) {
+        // Решта чужого кадру, прийнята до входу в mute
+    } else if (data == '\n' || data == '\r') {
+        UartLink_CompleteLine();
+    } else if (line->length < UART_LINE_SIZE - 1) {
+        line->data[line->length++] = data;
+    } else {
+        line->flags |= UART_LINE_OVERFLOW;
+    }
+}
+
+HOT_FUNC void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart != linkUart) {
+        return;
+    }
+    uint8_t data = rxByte;
+
+    UartLink_Arm();
+    UartLink_Receive(data);
+}
+
+#if VECTORS_RAM_ENABLED
+// Обробник USART2 прямо у векторі. Байт без помилок забирається з DR
+// одразу; HAL лишається увімкненим на прийом (RXNEIE, стан BUSY_RX) і
+// отримує керування лише для помилок і завершення передачі DMA (TC).
+static HOT_FUNC void UartLink_IRQHandler(void) {
+    USART_TypeDef *uart = linkUart->Instance;
+    IsrFrame frame;
+
+    IsrMonitor_Enter(&frame);
+    uint32_t status = uart->SR;
+    if ((status & (USART_SR_RXNE | UART_SR_ERRORS)) == USART_SR_RXNE) {
+        UartLink_Receive((uint8_t)uart->DR);
+        status = uart->SR;
+    }
+    if ((status & (USART_SR_RXNE | UART_SR_ERRORS)) ||
+        ((status & USART_SR_TC) && (uart->CR1 & USART_CR1_TCIE))) {
+        HAL_UART_IRQHandler(linkUart);
+    }
+    IsrMonitor_Exit(&frame, ISR_MONITOR_UART, ISR_MONITOR_NO_LATENCY);
+}
+#endif
+
+HOT_FUNC void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart != linkUart) {
+        return;
+    }
+    txTail = (txTail + txChunk) & (TX_RING_SIZE - 1);
+    txBusy = 0;
+    UartLink_Kick();
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (huart != linkUart) {
+        return;
+    }
+    uint32_t error = huart->ErrorCode;
+    if (error & HAL_UART_ERROR_ORE) linkStats.overrun++;
+    if (error & HAL_UART_ERROR_FE)  linkStats.framing++;
+    if (error & HAL_UART_ERROR_NE)  linkStats.noise++;
+    if (error & HAL_UART_ERROR_PE)  linkStats.parity++;
+
+    // Блокуючі помилки (ORE) зупиняють прийом - перезапускаємо одразу,
+    // після неблокуючих (FE/NE/PE) HAL продовжує прийом сам
+    if (huart->RxState == HAL_UART_STATE_READY) {
+        UartLink_Arm();
+    }
+    // Помилка DMA обриває передачу - шматок відкидається, черга йде далі
+    if (txBusy && huart->gState == HAL_UART_STATE_READY) {
+        txTail = (txTail + txChunk) & (TX_RING_SIZE - 1);
+        txBusy = 0;
+        UartLink_Kick();
+    }
+}
@@ -0,0 +1,39 @@
+#include "vectors.h"
+#include <string.h>
+
+// Таблиця векторів у SRAM. Після скидання VTOR вказує на таблицю у flash
+// (startup), де кожен обробник фіксований і здебільшого лише передає
+// керування HAL_xxx_IRQHandler. Копія в SRAM дозволяє під час роботи
+// ставити обробник прямо у вектор: швидкий шлях без HAL, обгортку для
+// профілювання тощо. Без Vectors_Init усе працює, як раніше.
+
+// VTOR вимагає вирівнювання на степінь двійки, не меншу за розмір таблиці
+static VectorHandler ramVectors[VECTORS_COUNT] __ALIGNED(512);
+
+void Vectors_Init(void) {
+#if VECTORS_RAM_ENABLED
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memcpy(ramVectors, (const void *)SCB->VTOR, sizeof(ramVectors));
+    SCB->VTOR = (uint32_t)ramVectors;
+    __DSB();
+    __set_PRIMASK(primask);
+#endif
+}
+
+// Новий обробник переривання; повертає попередній (для обгорток) або
+// NULL, якщо таблиця лишилася у flash і підміна неможлива
+VectorHandler Vectors_Install(IRQn_Type irq, VectorHandler handler) {
+    if (SCB->VTOR != (uint32_t)ramVectors) {
+        return NULL;
+    }
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    VectorHandler previous = ramVectors[16 + irq];
+    ramVectors[16 + irq] = handler;
+    __DSB();
+    __set_PRIMASK(primask);
+    return previous;
+}
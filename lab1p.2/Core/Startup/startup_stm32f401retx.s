@@ -60,45 +60,100 @@ defined in linker script */
 Reset_Handler:  
   ldr   sp, =_estack    		 /* set stack pointer */
 
+/* Start the DWT cycle counter: reset-to-main stages for the BOOT command */
+  ldr r0, =0xE000EDFC      /* CoreDebug->DEMCR */
+  ldr r1, [r0]
+  orr r1, r1, #0x01000000  /* TRCENA */
+  str r1, [r0]
+  ldr r0, =0xE0001000      /* DWT->CTRL */
+  movs r1, #0
+  str r1, [r0, #4]         /* DWT->CYCCNT */
+  ldr r1, [r0]
+  orr r1, r1, #1           /* CYCCNTENA */
+  str r1, [r0]
+
 /* Call the clock system initialization function.*/
   bl  SystemInit  
 
-/* Copy the data segment initializers from flash to SRAM */  
+/* Switch to the 84 MHz PLL before the bulk RAM initialization (boot.c) */
+  bl  Boot_ClockInit
+
+/* Copy the data segment initializers from flash to SRAM, 16 bytes per
+   LDM/STM pair, then the remaining words */
   ldr r0, =_sdata
   ldr r1, =_edata
   ldr r2, =_sidata
-  movs r3, #0
+  subs r3, r1, r0
+  bic r3, r3, #15
+  adds r3, r0, r3
+  b LoopCopyDataBlock
+
+CopyDataBlock:
+  ldmia r2!, {r4, r5, r6, r7}
+  stmia r0!, {r4, r5, r6, r7}
+
+LoopCopyDataBlock:
+  cmp r0, r3
+  bcc CopyDataBlock
   b LoopCopyDataInit
 
 CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
+  ldr r4, [r2], #4
+  str r4, [r0], #4
 
 LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
+  cmp r0, r1
   bcc CopyDataInit
-  
-/* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
-  movs r3, #0
-  b LoopFillZerobss
 
-FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
+/* SystemCoreClock lives in .data: refresh it for the PLL set above */
+  bl  SystemCoreClockUpdate
+
+/* Zero fill the bss segment. .noinit (after .bss) is left untouched */
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  movs r4, #0
+  bl FillWords
 
-LoopFillZerobss:
-  cmp r2, r4
-  bcc FillZerobss
+/* Paint free RAM from the heap start up to the stack with MEMORY_PAINT
+   (memory.c) to find the stack high-water mark at run time */
+  ldr r0, =_end
+  mov r1, sp
+  ldr r4, =0xA5A5A5A5
+  bl FillWords
  
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
   bl  main
   bx  lr    
+
+/* Fill words [r0, r1) with r4: 16 bytes per STM, then the remaining words.
+   Both bounds are word aligned. Clobbers r0, r2, r5-r7 */
+  .thumb_func
+FillWords:
+  mov r5, r4
+  mov r6, r4
+  mov r7, r4
+  subs r2, r1, r0
+  bic r2, r2, #15
+  adds r2, r0, r2
+  b LoopFillBlock
+
+FillBlock:
+  stmia r0!, {r4, r5, r6, r7}
+
+LoopFillBlock:
+  cmp r0, r2
+  bcc FillBlock
+  b LoopFillWord
+
+FillWord:
+  str r4, [r0], #4
+
+LoopFillWord:
+  cmp r0, r1
+  bcc FillWord
+  bx lr
 .size  Reset_Handler, .-Reset_Handler
 
 /**
@@ -0,0 +1,265 @@
+// Перевірка EventQueue на хості: перебір усіх витіснень переривань.
+//
+//   gcc -O2 -Wall -ICore/Inc -o /tmp/event_queue_check Tools/host/event_queue_check.c
+//   /tmp/event_queue_check
+//
+// LDREX/STREX/CLREX/DMB замінено моделлю одного ядра Cortex-M: локальний
+// монітор ексклюзивного доступу, який скидається на вході у виняток і
+// виході з нього. Кожен виклик примітиву - точка, де може спрацювати
+// переривання вищого пріоритету і додати власну подію. Перевірник
+// обходить усі розклади (до PREEMPT_LIMIT витіснень, вкладеність до
+// NEST_LIMIT) і після кожного перевіряє, що жодна подія не загублена,
+// не продубльована і не прочитана наполовину, а dropped рахує лише
+// справжнє переповнення. Далі - довгий випадковий прогін зі споживачем.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// main.h тягне HAL - замість нього лише модель ядра
+#define __MAIN_H
+
+static void Model_Point(void);
+
+static volatile uint32_t *monitorAddress; // NULL - монітор скинуто
+
+static uint32_t __LDREXW(volatile uint32_t *address) {
+    uint32_t value = *address;
+    monitorAddress = address;
+    Model_Point();
+    return value;
+}
+
+static uint32_t __STREXW(uint32_t value, volatile uint32_t *address) {
+    Model_Point();
+    if (monitorAddress != address) {
+        return 1;
+    }
+    *address = value;
+    monitorAddress = NULL;
+    return 0;
+}
+
+static void __CLREX(void) {
+    monitorAddress = NULL;
+    Model_Point();
+}
+
+static void __DMB(void) {
+    Model_Point();
+}
+
+#include "../../Core/Src/event_queue.c"
+
+#define PREEMPT_LIMIT 3
+#define NEST_LIMIT    2
+#define MAX_CHOICES   256
+#define MAX_POSTS     64
+
+static EventQueue queue;
+
+// Розклад: рішення в кожній точці (0 - далі, 1 - витіснення)
+static uint8_t choices[MAX_CHOICES];
+static uint8_t choiceLimits[MAX_CHOICES];
+static uint32_t choiceCount;
+static uint32_t choiceDepth;
+static uint8_t randomMode;
+static uint8_t quiet; // Підготовка черги - без витіснень
+
+static uint32_t nesting;
+static uint32_t preemptions;
+
+static uint32_t posted;   // Post повернув 1
+static uint32_t refused;  // Post повернув 0
+static uint32_t nextData; // Унікальний номер кожної події
+
+static uint8_t seen[MAX_POSTS * 64];
+static uint32_t seenCount;
+
+static void Model_Post(void) {
+    uint32_t data = nextData++;
+    if (EventQueue_Post(&queue, (uint16_t)(data & 0xFFFF), (uint16_t)~data, data)) {
+        posted++;
+    } else {
+        refused++;
+    }
+}
+
+static uint8_t Model_Choose(uint8_t limit) {
+    if (quiet) {
+        return 0;
+    }
+    if (randomMode) {
+        return (uint8_t)(rand() % 8 == 0 ? 1 : 0) & limit;
+    }
+    if (choiceCount >= MAX_CHOICES) {
+        fprintf(stderr, "schedule too long\n");
+        exit(2);
+    }
+    if (choiceCount == choiceDepth) {
+        choices[choiceDepth] = 0;
+        choiceLimits[choiceDepth] = limit;
+        choiceDepth++;
+    }
+    return choices[choiceCount++];
+}
+
+// Переривання: монітор скидається на вході і на виході
+static void Model_Point(void) {
+    uint8_t limit = (nesting < NEST_LIMIT && (randomMode || preemptions < PREEMPT_LIMIT)) ? 1 : 0;
+
+    if (Model_Choose(limit)) {
+        preemptions++;
+        nesting++;
+        monitorAddress = NULL;
+        Model_Post();
+        monitorAddress = NULL;
+        nesting--;
+    }
+}
+
+// Наступний розклад у порядку перебору; 0 - все обійдено
+static int Model_NextSchedule(void) {
+    while (choiceDepth > 0 && choices[choiceDepth - 1] >= choiceLimits[choiceDepth - 1]) {
+        choiceDepth--;
+    }
+    if (choiceDepth == 0) {
+        return 0;
+    }
+    choices[choiceDepth - 1]++;
+    return 1;
+}
+
+static int Model_Fail(const char *what) {
+    printf("FAIL: %s (posted=%u refused=%u dropped=%u head=%u tail=%u)\n", what,
+           posted, refused, EventQueue_Dropped(&queue), queue.head, queue.tail);
+    printf("schedule:");
+    for (uint32_t i = 0; i < choiceCount; i++) {
+        printf(" %u", choices[i]);
+    }
+    printf("\n");
+    return 1;
+}
+
+static int Model_TakeAll(void) {
+    Event event;
+
+    while (EventQueue_Take(&queue, &event)) {
+        if (event.type != (uint16_t)(event.data & 0xFFFF) || event.arg != (uint16_t)~event.data) {
+            return Model_Fail("torn event");
+        }
+        if (event.data >= sizeof(seen) || seen[event.data]) {
+            return Model_Fail("duplicate event");
+        }
+        seen[event.data] = 1;
+        seenCount++;
+    }
+    return 0;
+}
+
+// Один прогін: у черзі вже prefill подій, головний цикл додає mainPosts
+static int Model_Run(uint32_t prefill, uint32_t mainPosts) {
+    EventQueue_Init(&queue);
+    monitorAddress = NULL;
+    choiceCount = 0;
+    nesting = 0;
+    preemptions = 0;
+    posted = refused = nextData = 0;
+    memset(seen, 0, sizeof(seen));
+    seenCount = 0;
+
+    // Зсув на майже повне коло, щоб перевірити перехід через межу масиву
+    quiet = 1;
+    for (uint32_t i = 0; i < EVENT_QUEUE_SIZE - 3; i++) {
+        Event event;
+        EventQueue_Post(&queue, 0, 0, 0);
+        EventQueue_Take(&queue, &event);
+    }
+    for (uint32_t i = 0; i < prefill; i++) {
+        Model_Post();
+    }
+    quiet = 0;
+
+    for (uint32_t i = 0; i < mainPosts; i++) {
+        Model_Post();
+    }
+
+    uint32_t total = posted + refused;
+    uint32_t expected = total < EVENT_QUEUE_SIZE ? total : EVENT_QUEUE_SIZE;
+    if (posted != expected) {
+        return Model_Fail(refused > 0 && total <= EVENT_QUEUE_SIZE ? "spurious drop" : "wrong post count");
+    }
+    if (EventQueue_Dropped(&queue) != refused) {
+        return Model_Fail("dropped counter");
+    }
+    if (Model_TakeAll() != 0) {
+        return 1;
+    }
+    if (seenCount != posted) {
+        return Model_Fail("lost event");
+    }
+    return 0;
+}
+
+static int Model_Exhaustive(uint32_t prefill, uint32_t mainPosts) {
+    uint32_t schedules = 0;
+
+    randomMode = 0;
+    choiceDepth = 0;
+    do {
+        schedules++;
+        if (Model_Run(prefill, mainPosts) != 0) {
+            return 1;
+        }
+    } while (Model_NextSchedule());
+    printf("prefill=%-2u posts=%u: %u schedules ok\n", prefill, mainPosts, schedules);
+    return 0;
+}
+
+// Довгий прогін: головний цикл по черзі додає і читає, переривання
+// випадкові. Переповнення тут можливе, тож перевіряється лише, що всі
+// прийняті події прочитано рівно раз і dropped збігається з відмовами
+static int Model_Random(uint32_t rounds) {
+    uint32_t refusedTotal = 0;
+
+    randomMode = 1;
+    srand(1);
+    EventQueue_Init(&queue);
+    monitorAddress = NULL;
+    nesting = 0;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        posted = refused = nextData = 0;
+        memset(seen, 0, sizeof(seen));
+        seenCount = 0;
+        for (uint32_t i = 0; i < 8; i++) {
+            Model_Post();
+        }
+        if (Model_TakeAll() != 0) {
+            return 1;
+        }
+        if (seenCount != posted) {
+            return Model_Fail("lost event");
+        }
+        refusedTotal += refused;
+        if (EventQueue_Dropped(&queue) != refusedTotal) {
+            return Model_Fail("dropped counter");
+        }
+    }
+    printf("random: %u rounds ok, %u dropped on overflow\n", rounds, refusedTotal);
+    return 0;
+}
+
+int main(void) {
+    static const uint32_t prefills[] = {0, EVENT_QUEUE_SIZE - 4, EVENT_QUEUE_SIZE - 1, EVENT_QUEUE_SIZE};
+
+    for (uint32_t i = 0; i < sizeof(prefills) / sizeof(prefills[0]); i++) {
+        for (uint32_t posts = 1; posts <= 2; posts++) {
+            if (Model_Exhaustive(prefills[i], posts) != 0) {
+                return 1;
+            }
+        }
+    }
+    return Model_Random(200000);
+}
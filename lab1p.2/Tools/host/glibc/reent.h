@@ -0,0 +1,12 @@
+// Замінник <reent.h> newlib для збирання на хості з glibc
+#ifndef __HOST_REENT_H
+#define __HOST_REENT_H
+
+struct _reent {
+    int _errno;
+};
+
+static struct _reent hostReent;
+#define _REENT (&hostReent)
+
+#endif /* __HOST_REENT_H */
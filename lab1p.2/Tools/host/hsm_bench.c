@@ -0,0 +1,314 @@
+// Перевірка і вимірювання Hsm на хості.
+//
+//   gcc -O2 -Wall -ICore/Inc -o /tmp/hsm_bench Tools/host/hsm_bench.c
+//   /tmp/hsm_bench
+//
+// Спершу порядок виходів, дії і входів для типових переходів, відмова
+// Hsm_Init від таблиці, глибшої за HSM_MAX_DEPTH (Error_Handler), і
+// вступ lab2 з командою L= посеред ефекту. Далі
+// час диспетчеризації з листа на глибині HSM_MAX_DEPTH - 1: зведена
+// таблиця проти пошуку переходу вгору по предках, як без Hsm_Init.
+
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// main.h тягне HAL - замість нього лише Error_Handler
+#define __MAIN_H
+
+static jmp_buf errorJump;
+
+static void Error_Handler(void) {
+    longjmp(errorJump, 1);
+}
+
+#include "../../Core/Src/hsm.c"
+
+#define BENCH_ROUNDS 20000000
+
+static char trace[256];
+
+static void Trace(const char *text) {
+    strncat(trace, text, sizeof(trace) - strlen(trace) - 1);
+}
+
+#define TRACE_STATE(name)                                              \
+    static void name##_Entry(Hsm *hsm, const Event *event) {           \
+        (void)hsm;                                                     \
+        (void)event;                                                   \
+        Trace("+" #name);                                              \
+    }                                                                  \
+    static void name##_Exit(Hsm *hsm, const Event *event) {            \
+        (void)hsm;                                                     \
+        (void)event;                                                   \
+        Trace("-" #name);                                              \
+    }
+
+TRACE_STATE(T)
+TRACE_STATE(A)
+TRACE_STATE(A1)
+TRACE_STATE(A2)
+TRACE_STATE(B)
+TRACE_STATE(B1)
+
+static void Action(Hsm *hsm, const Event *event) {
+    (void)hsm;
+    (void)event;
+    Trace("!");
+}
+
+enum { S_T, S_A, S_A1, S_A2, S_B, S_B1 };
+
+static const HsmTransition tTransitions[] = { { 1, HSM_INTERNAL, Action } };
+static const HsmTransition aTransitions[] = { { 2, S_B1, Action }, { 3, S_A, NULL } };
+static const HsmTransition a1Transitions[] = { { 2, S_A2, Action } };
+static const HsmTransition a2Transitions[] = { { 4, S_A2, NULL } };
+
+static const HsmState traceStates[] = {
+    [S_T]  = { "T",  HSM_NONE, S_A,  T_Entry,  T_Exit,  HSM_TRANSITIONS(tTransitions) },
+    [S_A]  = { "A",  S_T,      S_A1, A_Entry,  A_Exit,  HSM_TRANSITIONS(aTransitions) },
+    [S_A1] = { "A1", S_A,  HSM_NONE, A1_Entry, A1_Exit, HSM_TRANSITIONS(a1Transitions) },
+    [S_A2] = { "A2", S_A,  HSM_NONE, A2_Entry, A2_Exit, HSM_TRANSITIONS(a2Transitions) },
+    [S_B]  = { "B",  S_T,      S_B1, B_Entry,  B_Exit,  HSM_NO_TRANSITIONS },
+    [S_B1] = { "B1", S_B,  HSM_NONE, B1_Entry, B1_Exit, HSM_NO_TRANSITIONS },
+};
+
+typedef struct {
+    uint8_t event;
+    const char *trace;
+    uint8_t state;
+} TraceStep;
+
+static const TraceStep traceSteps[] = {
+    { 1, "!",                S_A1 }, // Внутрішній перехід кореня
+    { 2, "-A1!+A2",          S_A2 }, // Перевизначений у листі
+    { 4, "-A2+A2",           S_A2 }, // Сам у себе - повторний вхід
+    { 3, "-A2-A+A+A1",       S_A1 }, // У предка
+    { 2, "-A1!+A2",          S_A2 },
+    { 2, "-A2-A!+B+B1",      S_B1 }, // Успадкований від A
+    { 5, "",                 S_B1 }, // Не обробляється
+};
+
+static int Bench_Trace(void) {
+    Hsm hsm;
+
+    Hsm_Init(&hsm, traceStates, sizeof(traceStates) / sizeof(traceStates[0]), NULL);
+    trace[0] = '\0';
+    Hsm_Start(&hsm);
+    if (strcmp(trace, "+T+A+A1") != 0 || hsm.current != S_A1) {
+        printf("FAIL: start %s\n", trace);
+        return 1;
+    }
+    for (uint32_t i = 0; i < sizeof(traceSteps) / sizeof(traceSteps[0]); i++) {
+        Event event = { .type = traceSteps[i].event };
+        trace[0] = '\0';
+        Hsm_Dispatch(&hsm, &event);
+        if (strcmp(trace, traceSteps[i].trace) != 0 || hsm.current != traceSteps[i].state) {
+            printf("FAIL: step %u: %s -> %s, expected %s -> %s\n", i, trace,
+                   traceStates[hsm.current].name, traceSteps[i].trace,
+                   traceStates[traceSteps[i].state].name);
+            return 1;
+        }
+    }
+    printf("transitions ok\n");
+    return 0;
+}
+
+// Вступ lab2: рядки UART обробляє корінь, FADE_IN чекає на кінець
+// ефекту. L= під час ефекту зупиняє його без Effect_DoneCallback, тож
+// FADE_IN сам перевіряє ефект після команд і не застрягає
+enum { INTRO_EVENT_BUTTON, INTRO_EVENT_LINE, INTRO_EVENT_FADE_DONE };
+enum { I_TOP, I_INTRO, I_FADE_IN, I_WAIT, I_BLINK };
+
+static uint8_t introEffectRunning;
+static uint8_t introPosted[4];
+static uint8_t introPostedCount;
+
+static void Intro_Post(uint8_t type) {
+    if (introPostedCount < sizeof(introPosted)) {
+        introPosted[introPostedCount++] = type;
+    }
+}
+
+static void Intro_Execute(Hsm *hsm, const Event *event) {
+    (void)hsm;
+    // Рядок "L=xx": Effect_Stop, колбек завершення не викликається
+    if (event->arg == 'L') {
+        introEffectRunning = 0;
+    }
+}
+
+static void Intro_FadeCommands(Hsm *hsm, const Event *event) {
+    Intro_Execute(hsm, event);
+    if (!introEffectRunning) {
+        Intro_Post(INTRO_EVENT_FADE_DONE);
+    }
+}
+
+static void Intro_FadeEntry(Hsm *hsm, const Event *event) {
+    (void)hsm;
+    (void)event;
+    introEffectRunning = 1;
+}
+
+static const HsmTransition introTopTransitions[] = {
+    { INTRO_EVENT_LINE, HSM_INTERNAL, Intro_Execute },
+};
+static const HsmTransition introFadeTransitions[] = {
+    { INTRO_EVENT_FADE_DONE, I_WAIT,       NULL },
+    { INTRO_EVENT_LINE,      HSM_INTERNAL, Intro_FadeCommands },
+};
+static const HsmTransition introWaitTransitions[] = {
+    { INTRO_EVENT_BUTTON, I_BLINK, NULL },
+};
+
+static const HsmState introStates[] = {
+    [I_TOP]     = { "top",     HSM_NONE, I_INTRO,   NULL, NULL, HSM_TRANSITIONS(introTopTransitions) },
+    [I_INTRO]   = { "intro",   I_TOP,    I_FADE_IN, NULL, NULL, HSM_NO_TRANSITIONS },
+    [I_FADE_IN] = { "fade-in", I_INTRO,  HSM_NONE, Intro_FadeEntry, NULL, HSM_TRANSITIONS(introFadeTransitions) },
+    [I_WAIT]    = { "wait",    I_INTRO,  HSM_NONE, NULL, NULL, HSM_TRANSITIONS(introWaitTransitions) },
+    [I_BLINK]   = { "blink",   I_INTRO,  HSM_NONE, NULL, NULL, HSM_NO_TRANSITIONS },
+};
+
+// Подія, а за нею все, що дії встигли додати в чергу (як головний цикл)
+static void Intro_Dispatch(Hsm *hsm, uint8_t type, uint8_t arg) {
+    Event event = { .type = type, .arg = arg };
+    Hsm_Dispatch(hsm, &event);
+    for (uint8_t i = 0; i < introPostedCount; i++) {
+        Event posted = { .type = introPosted[i] };
+        Hsm_Dispatch(hsm, &posted);
+    }
+    introPostedCount = 0;
+}
+
+static int Bench_Intro(void) {
+    Hsm hsm;
+
+    // Рядок, що не чіпає ефект (STATS), лишає вступ у FADE_IN
+    Hsm_Init(&hsm, introStates, sizeof(introStates) / sizeof(introStates[0]), NULL);
+    Hsm_Start(&hsm);
+    Intro_Dispatch(&hsm, INTRO_EVENT_LINE, 'S');
+    if (hsm.current != I_FADE_IN) {
+        printf("FAIL: intro left FADE_IN on a query\n");
+        return 1;
+    }
+    // L= під час вступу: ефект зупинено, кнопка має знову діяти
+    Intro_Dispatch(&hsm, INTRO_EVENT_LINE, 'L');
+    Intro_Dispatch(&hsm, INTRO_EVENT_BUTTON, 0);
+    if (hsm.current != I_BLINK) {
+        printf("FAIL: L= during intro left the machine in %s\n", introStates[hsm.current].name);
+        return 1;
+    }
+    printf("L= during intro ok\n");
+    return 0;
+}
+
+// Ланцюжок depth рівнів: 0 - корінь, кожен наступний - єдиний підстан
+static HsmState chain[HSM_MAX_STATES];
+static const HsmTransition rootTransitions[] = { { 1, HSM_INTERNAL, NULL }, { 2, 0, NULL } };
+
+static void Bench_Chain(uint8_t depth) {
+    memset(chain, 0, sizeof(chain));
+    for (uint8_t i = 0; i < depth; i++) {
+        chain[i].name = "chain";
+        chain[i].parent = i ? i - 1 : HSM_NONE;
+        chain[i].initial = (i + 1 < depth) ? i + 1 : HSM_NONE;
+    }
+    chain[0].transitions = rootTransitions;
+    chain[0].transitionCount = sizeof(rootTransitions) / sizeof(rootTransitions[0]);
+}
+
+// Таблиця глибша за HSM_MAX_DEPTH і цикл батьків мають зупинити Hsm_Init
+static int Bench_Depth(void) {
+    static Hsm hsm;
+
+    Bench_Chain(HSM_MAX_DEPTH);
+    if (setjmp(errorJump)) {
+        printf("FAIL: depth %u rejected\n", HSM_MAX_DEPTH);
+        return 1;
+    }
+    Hsm_Init(&hsm, chain, HSM_MAX_DEPTH, NULL);
+
+    Bench_Chain(HSM_MAX_DEPTH + 1);
+    if (!setjmp(errorJump)) {
+        Hsm_Init(&hsm, chain, HSM_MAX_DEPTH + 1, NULL);
+        printf("FAIL: depth %u accepted\n", HSM_MAX_DEPTH + 1);
+        return 1;
+    }
+
+    Bench_Chain(3);
+    chain[0].parent = 2;
+    if (!setjmp(errorJump)) {
+        Hsm_Init(&hsm, chain, 3, NULL);
+        printf("FAIL: parent cycle accepted\n");
+        return 1;
+    }
+    printf("depth limit ok\n");
+    return 0;
+}
+
+// Пошук переходу без зведеної таблиці: від листа вгору по предках
+static const HsmTransition *Bench_FindWalk(const Hsm *hsm, uint8_t event) {
+    for (uint8_t owner = hsm->current; owner != HSM_NONE; owner = hsm->states[owner].parent) {
+        const HsmState *state = &hsm->states[owner];
+        for (uint8_t i = 0; i < state->transitionCount; i++) {
+            if (state->transitions[i].event == event) {
+                return &state->transitions[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+static double Bench_Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static void Bench_Dispatch(void) {
+    static Hsm hsm;
+    static volatile uintptr_t sink;
+    const uint8_t depth = HSM_MAX_DEPTH;
+    Event internal = { .type = 1 };
+    Event reenter = { .type = 2 };
+
+    Bench_Chain(depth);
+    Hsm_Init(&hsm, chain, depth, NULL);
+    Hsm_Start(&hsm);
+
+    double start = Bench_Seconds();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        Hsm_Dispatch(&hsm, &internal);
+        __asm__ volatile("" ::: "memory");
+    }
+    double table = Bench_Seconds() - start;
+
+    start = Bench_Seconds();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        sink += (uintptr_t)Bench_FindWalk(&hsm, 1);
+        __asm__ volatile("" ::: "memory");
+    }
+    double walk = Bench_Seconds() - start;
+
+    start = Bench_Seconds();
+    for (uint32_t i = 0; i < BENCH_ROUNDS / 10; i++) {
+        Hsm_Dispatch(&hsm, &reenter);
+    }
+    double transit = Bench_Seconds() - start;
+
+    printf("leaf at depth %u, event handled by the root:\n", depth - 1);
+    printf("  table lookup + internal action %6.1f ns\n", table * 1e9 / BENCH_ROUNDS);
+    printf("  lookup walking the parents     %6.1f ns\n", walk * 1e9 / BENCH_ROUNDS);
+    printf("  transition to the root         %6.1f ns\n", transit * 1e9 / (BENCH_ROUNDS / 10));
+}
+
+int main(void) {
+    if (Bench_Trace() != 0 || Bench_Depth() != 0 || Bench_Intro() != 0) {
+        return 1;
+    }
+    Bench_Dispatch();
+    return 0;
+}
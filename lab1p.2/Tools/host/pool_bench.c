@@ -0,0 +1,193 @@
+// Порівняння malloc на пулах (pool.c) з malloc бібліотеки C.
+//
+// newlib-nano, як у прошивці: збирання з семіхостингом і запуск на платі
+// через налагоджувач або в qemu-system-arm -M mps2-an386 -semihosting:
+//   arm-none-eabi-gcc -O2 -mcpu=cortex-m4 -mthumb -ICore/Inc
+//       --specs=nano.specs --specs=rdimon.specs
+//       -o /tmp/pool_bench.elf Tools/host/pool_bench.c
+// Повний newlib - те саме без --specs=nano.specs. На хості з glibc
+// (лише для порівняння, замінник <reent.h> у Tools/host/glibc):
+//   gcc -O2 -ICore/Inc -ITools/host/glibc -o /tmp/pool_bench Tools/host/pool_bench.c
+//
+// Функції pool.c перейменовано, тож обидва розподільники живуть поруч,
+// а бібліотека C (буфер stdio тощо) користується своїм malloc.
+
+#include <setjmp.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// main.h тягне HAL - замість нього лише те, що потрібно pool.c
+#define __MAIN_H
+#define HOT_FUNC
+
+static jmp_buf errorJump;
+
+static void Error_Handler(void) {
+    longjmp(errorJump, 1);
+}
+
+static uint32_t __get_PRIMASK(void) {
+    return 0;
+}
+
+static void __disable_irq(void) {
+}
+
+static void __set_PRIMASK(uint32_t primask) {
+    (void)primask;
+}
+
+#define _malloc_r  Pool_MallocR
+#define _free_r    Pool_FreeR
+#define _calloc_r  Pool_CallocR
+#define _realloc_r Pool_ReallocR
+#define malloc     Pool_Malloc
+#define free       Pool_FreeBlock
+#define calloc     Pool_Calloc
+#define realloc    Pool_Realloc
+#include "../../Core/Src/pool.c"
+#undef malloc
+#undef free
+#undef calloc
+#undef realloc
+
+#define BENCH_ROUNDS 2000000
+#define BENCH_LIVE   8
+
+typedef struct {
+    void *(*alloc)(size_t size);
+    void (*release)(void *block);
+    void *(*resize)(void *block, size_t size);
+} Allocator;
+
+static const Allocator poolAllocator = { Pool_Malloc, Pool_FreeBlock, Pool_Realloc };
+static const Allocator libcAllocator = { malloc, free, realloc };
+
+static volatile uintptr_t sink;
+static uint32_t failures;
+
+static double Bench_Seconds(void) {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// Пара malloc/free одного розміру - рядок відповіді, тимчасовий буфер
+static void Bench_Pair(const Allocator *allocator) {
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        void *block = allocator->alloc(48);
+        failures += (block == NULL);
+        sink += (uintptr_t)block;
+        allocator->release(block);
+    }
+}
+
+// Кілька живих блоків різного розміру (1..64), звільнення врозкид
+static void Bench_Mixed(const Allocator *allocator) {
+    void *live[BENCH_LIVE] = { NULL };
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t slot = (seed >> 16) % BENCH_LIVE;
+        allocator->release(live[slot]);
+        live[slot] = allocator->alloc(((seed >> 8) & 63) + 1);
+        failures += (live[slot] == NULL);
+        sink += (uintptr_t)live[slot];
+    }
+    for (uint32_t i = 0; i < BENCH_LIVE; i++) {
+        allocator->release(live[i]);
+    }
+}
+
+// Буфер, що росте: 16 -> 64 -> 256 байтів через realloc
+static void Bench_Grow(const Allocator *allocator) {
+    for (uint32_t i = 0; i < BENCH_ROUNDS / 4; i++) {
+        uint8_t *block = allocator->alloc(16);
+        if (block == NULL) {
+            failures++;
+            continue;
+        }
+        block[0] = (uint8_t)i;
+        block = allocator->resize(block, 64);
+        block = allocator->resize(block, 256);
+        failures += (block == NULL || block[0] != (uint8_t)i);
+        sink += (uintptr_t)block;
+        allocator->release(block);
+    }
+}
+
+static void Bench_Run(const char *name, void (*bench)(const Allocator *), uint32_t ops) {
+    double start = Bench_Seconds();
+    bench(&poolAllocator);
+    double pool = Bench_Seconds() - start;
+
+    start = Bench_Seconds();
+    bench(&libcAllocator);
+    double libc = Bench_Seconds() - start;
+
+    printf("%-6s pool %7.1f ns  libc %7.1f ns\n", name, pool * 1e9 / ops, libc * 1e9 / ops);
+}
+
+// Поведінка, на яку покладається прошивка
+static int Bench_Check(void) {
+    static uint32_t foreign[4];
+    uint8_t *block = Pool_Malloc(10);
+
+    if (block == NULL) {
+        return 1;
+    }
+    memcpy(block, "0123456789", 10);
+    uint8_t *grown = Pool_Realloc(block, 200);
+    if (grown == NULL || memcmp(grown, "0123456789", 10) != 0) {
+        printf("FAIL: realloc lost data\n");
+        return 1;
+    }
+    Pool_FreeBlock(grown);
+    // Чужий вказівник не копіюється наосліп, а відхиляється
+    if (Pool_Realloc(foreign, 64) != NULL || _REENT->_errno != EINVAL) {
+        printf("FAIL: realloc accepted a foreign block\n");
+        return 1;
+    }
+    // Середина блоку, чужий вказівник і зайве звільнення - Error_Handler
+    uint8_t *inner = Pool_Malloc(10);
+    void *wrong[] = { inner + 4, foreign, inner };
+    for (uint32_t i = 0; i < sizeof(wrong) / sizeof(wrong[0]); i++) {
+        if (i == 2) {
+            Pool_FreeBlock(inner);
+        }
+        if (setjmp(errorJump) == 0) {
+            Pool_FreeBlock(wrong[i]);
+            printf("FAIL: free accepted bad pointer %u\n", i);
+            return 1;
+        }
+    }
+    if (Pool_Malloc(2048) != NULL) {
+        printf("FAIL: oversized request succeeded\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+#ifdef _NEWLIB_VERSION
+    printf("libc: newlib %s\n", _NEWLIB_VERSION);
+#else
+    printf("libc: not newlib\n");
+#endif
+    if (Bench_Check() != 0) {
+        return 1;
+    }
+    Bench_Run("pair", Bench_Pair, BENCH_ROUNDS);
+    Bench_Run("mixed", Bench_Mixed, BENCH_ROUNDS);
+    Bench_Run("grow", Bench_Grow, BENCH_ROUNDS / 4 * 3);
+
+    for (const Pool *pool = Pool_First(); pool != NULL; pool = pool->nextPool) {
+        printf("%-10s peak %2u/%-2u failures %lu\n", pool->name, pool->peak, pool->blockCount,
+               (unsigned long)pool->failures);
+    }
+    printf("allocation failures: %lu\n", (unsigned long)failures);
+    return 0;
+}
@@ -0,0 +1,393 @@
+#!/usr/bin/env python3
+"""Генератор навантаження для командного протоколу USART2.
+
+Надсилає команди на послідовний порт (плата або pty симулятора) із заданою
+сумішшю, темпом і пачками, вимірює час відповіді для кожної команди та
+рахує втрачені й помилкові відповіді. Результат - JSON, придатний для
+порівняння прогонів між версіями прошивки.
+
+Відповіді не несуть номера команди. У тихому режимі (V=0) уставки
+зіставляються з номерами підтверджень "A<n>": базовий номер дає
+підтвердження самої команди V=0. У режимах 1 і 2 відповіді йдуть по
+черзі, тож після першого тайм-ауту зіставлення втрачено: усі команди
+в дорозі рахуються втраченими, відправлення зупиняється, і надсилається
+запит синхронізації, якого немає в суміші (MEM тощо). Усі рядки до його
+впізнаваної відповіді рахуються як застарілі.
+
+Після паузи, довшої за --wake-gap, прошивка може спати в STOP, і байт,
+що її розбудив, губиться. Тому перед першою командою після паузи йде
+окремий '\n' і коротка затримка на запуск PLL; якщо вузол не спав,
+порожній рядок просто ігнорується.
+
+Приклад:
+    loadgen.py /dev/ttyACM0 --mix "L=10:4,L=90:4,STATS:1" --rate 20 \
+        --burst 5 --count 500 --json run.json
+"""
+
+import argparse
+import bisect
+import json
+import os
+import random
+import re
+import select
+import sys
+import termios
+import time
+from collections import deque
+
+# Кумулятивне підтвердження тихого режиму: "A<номер> <маска помилок>"
+ACK_LINE = re.compile(r"^A(\d+) ([0-9A-Fa-f]{8})$")
+
+# Запити прошивки: текстова відповідь у будь-якому режимі, без номера
+# підтвердження (Reply_Format у command.c). Решта, зокрема невідомі
+# команди, нумерується і підтверджується
+QUERY_COMMANDS = {"STATS", "DEFER", "POWER", "SETTINGS", "MEM", "POOL", "ISR", "BOOT", "KERNEL"}
+
+# Запити синхронізації і початок відповіді на них, у порядку вибору
+SYNC_QUERIES = (("MEM", "STACK="), ("SETTINGS", "REC="), ("POWER", "SLEEP="), ("STATS", "RX="))
+SYNC_ATTEMPTS = 5  # Без відповіді на стільки запитів поспіль лінія вважається втраченою
+
+# Межі кошиків гістограми затримок, мс; останній кошик - понад усі межі
+HISTOGRAM_MS = "1,2,5,10,20,50,100,200,500,1000"
+
+BAUD_RATES = {
+    9600: termios.B9600,
+    19200: termios.B19200,
+    38400: termios.B38400,
+    57600: termios.B57600,
+    115200: termios.B115200,
+}
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    attrs = termios.tcgetattr(fd)
+    # Сирий режим 8N1 без керування потоком
+    attrs[0] = 0
+    attrs[1] = 0
+    attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+    attrs[3] = 0
+    attrs[4] = attrs[5] = BAUD_RATES[baud]
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 0
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+def parse_mix(text):
+    """'L=10:4,STATS:1' -> [('L=10', 4), ('STATS', 1)]"""
+    mix = []
+    for item in text.split(","):
+        command, _, weight = item.rpartition(":")
+        if not command:
+            command, weight = weight, "1"
+        mix.append((command, int(weight)))
+    return mix
+
+
+def is_query(command):
+    name = command.strip().upper()
+    return name in QUERY_COMMANDS or name.startswith("BENCH ")
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return None
+    index = min(len(sorted_values) - 1, int(round(fraction * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def histogram(values, edges):
+    """Кількість затримок у кожному кошику (le_ms - верхня межа включно)."""
+    counts = [0] * (len(edges) + 1)
+    for value in values:
+        counts[bisect.bisect_left(edges, value)] += 1
+    return [{"le_ms": edge, "count": count} for edge, count in zip(edges + [None], counts)]
+
+
+def summarize(latencies_ms, edges):
+    values = sorted(latencies_ms)
+    return {
+        "count": len(values),
+        "p50_ms": percentile(values, 0.50),
+        "p99_ms": percentile(values, 0.99),
+        "max_ms": values[-1] if values else None,
+        "histogram": histogram(values, edges),
+    }
+
+
+class Link:
+    def __init__(self, fd, wake_gap=0.0, wake_delay=0.0):
+        self.fd = fd
+        self.pending = b""
+        self.wake_gap = wake_gap
+        self.wake_delay = wake_delay
+        self.last_send = None
+        self.wakes = 0
+
+    def send(self, data):
+        now = time.monotonic()
+        if self.wake_gap > 0 and (self.last_send is None or now - self.last_send >= self.wake_gap):
+            # Байт пробудження з STOP; сам він до прошивки не доходить
+            self.write(b"\n")
+            time.sleep(self.wake_delay)
+            self.wakes += 1
+        self.write(data)
+        self.last_send = time.monotonic()
+
+    def write(self, data):
+        view = memoryview(data)
+        while view:
+            _, writable, _ = select.select([], [self.fd], [], 1.0)
+            if writable:
+                view = view[os.write(self.fd, view):]
+
+    def read_lines(self, timeout):
+        """Повертає список (час_отримання, рядок), що прийшли за timeout."""
+        lines = []
+        readable, _, _ = select.select([self.fd], [], [], max(timeout, 0))
+        if readable:
+            try:
+                self.pending += os.read(self.fd, 4096)
+            except BlockingIOError:
+                pass
+            now = time.monotonic()
+            while True:
+                cut = min((i for i in (self.pending.find(b"\r"), self.pending.find(b"\n")) if i >= 0),
+                          default=-1)
+                if cut < 0:
+                    break
+                line, self.pending = self.pending[:cut], self.pending[cut + 1:]
+                if line:
+                    lines.append((now, line.decode("ascii", "replace")))
+        return lines
+
+
+def run(args):
+    fd = open_port(args.port, args.baud)
+    link = Link(fd, args.wake_gap, args.wake_delay)
+    rng = random.Random(args.seed)
+    mix = parse_mix(args.mix)
+    commands, weights = zip(*mix)
+    edges = sorted(float(edge) for edge in args.histogram.split(","))
+    prefix = bytes([args.address]) if args.address is not None else b""
+    ack_sequence = None  # Останній підтверджений номер (тихий режим)
+    if args.reply_mode != 2:
+        # Перемикаємо прошивку в потрібний режим; відповідь уже в новому режимі
+        link.send(prefix + b"V=%d\r\n" % args.reply_mode)
+        time.sleep(0.2 if args.reply_mode else args.timeout)
+        for _, line in link.read_lines(0):
+            ack = ACK_LINE.match(line)
+            if ack:
+                ack_sequence = int(ack.group(1))
+        if args.reply_mode == 0 and ack_sequence is None:
+            raise SystemExit("no acknowledgement for V=0, cannot number commands")
+
+    outstanding = deque()          # [команда, час відправлення, номер підтвердження]
+    latencies = {c: [] for c in commands}
+    errors = {c: 0 for c in commands}
+    dropped = {c: 0 for c in commands}
+    unexpected = 0
+    stale = 0                      # Відповіді на команди, вже зараховані втраченими
+    untracked = 0                  # Запити в тихому режимі: без підтвердження
+    skipped_lines = 0              # Текст у тихому режимі (відповіді на запити)
+    sync_deadline = None           # Очікування відповіді на запит синхронізації
+    sync_attempts = 0              # Запитів синхронізації без відповіді поспіль
+    sync_extra = 0                 # Ще очікувані відповіді на повторні запити
+    resyncs = 0
+    names = {c.strip().upper() for c in commands}
+    sync = next((q for q in SYNC_QUERIES if q[0] not in names), None)
+    if args.reply_mode != 0 and sync is None:
+        raise SystemExit("every sync query is in the mix, replies cannot be resynchronized")
+
+    period = 1.0 / args.rate if args.rate > 0 else 0.0
+    sent = 0
+    next_sequence = ack_sequence
+    next_send = time.monotonic()
+    started = next_send
+
+    def complete(entry, stamp, failed):
+        command = entry[0]
+        latencies[command].append((stamp - entry[1]) * 1000.0)
+        if failed:
+            errors[command] += 1
+
+    def acknowledge(stamp, sequence, mask):
+        # Одне підтвердження закриває всі команди до вказаного номера
+        nonlocal ack_sequence, stale
+        covered = (sequence - ack_sequence) & 0xFFFF
+        ack_sequence = sequence
+        closed = 0
+        while outstanding and (sequence - outstanding[0][2]) & 0xFFFF < covered:
+            age = (sequence - outstanding[0][2]) & 0xFFFF
+            complete(outstanding.popleft(), stamp, age < 32 and (mask >> age) & 1)
+            closed += 1
+        stale += covered - closed
+
+    def resync(now):
+        nonlocal sync_deadline, sync_attempts, resyncs
+        if sync_attempts == 0:
+            resyncs += 1
+        sync_attempts += 1
+        link.send(prefix + sync[0].encode("ascii") + b"\r\n")
+        sync_deadline = now + args.timeout
+
+    def collect(timeout):
+        nonlocal unexpected, stale, skipped_lines, sync_deadline, sync_attempts, sync_extra
+        for stamp, line in link.read_lines(timeout):
+            if args.reply_mode == 0:
+                ack = ACK_LINE.match(line)
+                if ack:
+                    acknowledge(stamp, int(ack.group(1)), int(ack.group(2), 16))
+                else:
+                    skipped_lines += 1
+                continue
+            if sync_deadline is not None:
+                if line.startswith(sync[1]):
+                    sync_deadline = None # Далі відповіді знову по черзі
+                    sync_extra = sync_attempts - 1
+                    sync_attempts = 0
+                else:
+                    stale += 1
+                continue
+            if sync_extra and line.startswith(sync[1]):
+                sync_extra -= 1 # Запізніла відповідь на повторний запит
+                continue
+            if not outstanding:
+                unexpected += 1
+                continue
+            entry = outstanding.popleft()
+            if args.reply_mode == 1 and not is_query(entry[0]):
+                complete(entry, stamp, line != "0")
+            else:
+                complete(entry, stamp, line.startswith("Error"))
+
+    def expire(now):
+        # Відповіді, що не прийшли за timeout, вважаються втраченими
+        if not outstanding or now - outstanding[0][1] <= args.timeout:
+            return
+        if args.reply_mode == 0:
+            while outstanding and now - outstanding[0][1] > args.timeout:
+                dropped[outstanding.popleft()[0]] += 1
+            return
+        # Без номерів не відомо, чия наступна відповідь: скидаємо все в дорозі
+        while outstanding:
+            dropped[outstanding.popleft()[0]] += 1
+        resync(now)
+
+    while sent < args.count:
+        now = time.monotonic()
+        expire(now)
+        if sync_deadline is not None and now >= sync_deadline:
+            if sync_attempts >= SYNC_ATTEMPTS:
+                break
+            resync(now) # Запит або відповідь загубились
+        if sync_deadline is None and now >= next_send and len(outstanding) < args.window:
+            for _ in range(min(args.burst, args.count - sent)):
+                command = rng.choices(commands, weights)[0]
+                link.send(prefix + command.encode("ascii") + b"\r\n")
+                sent += 1
+                if args.reply_mode == 0:
+                    if is_query(command):
+                        untracked += 1
+                        continue
+                    next_sequence = (next_sequence + 1) & 0xFFFF
+                outstanding.append([command, time.monotonic(), next_sequence])
+            next_send += period * args.burst + args.gap
+        collect(min(0.005, max(next_send - time.monotonic(), 0)))
+
+    deadline = time.monotonic() + args.timeout
+    while outstanding and time.monotonic() < deadline:
+        collect(0.01)
+    for entry in outstanding:
+        dropped[entry[0]] += 1
+    elapsed = time.monotonic() - started
+    os.close(fd)
+
+    all_latencies = [v for values in latencies.values() for v in values]
+    return {
+        "port": args.port,
+        "baud": args.baud,
+        "mix": args.mix,
+        "rate": args.rate,
+        "burst": args.burst,
+        "reply_mode": args.reply_mode,
+        "sent": sent,
+        "elapsed_s": elapsed,
+        "throughput_cmd_s": sent / elapsed if elapsed > 0 else None,
+        "dropped": sum(dropped.values()),
+        "errors": sum(errors.values()),
+        "unexpected_replies": unexpected,
+        "stale_replies": stale,
+        "resyncs": resyncs,
+        "wake_bytes": link.wakes,
+        "link_lost": sync_attempts >= SYNC_ATTEMPTS,
+        "untracked": untracked,
+        "skipped_lines": skipped_lines,
+        "latency": summarize(all_latencies, edges),
+        "per_command": {
+            c: dict(summarize(latencies[c], edges), errors=errors[c], dropped=dropped[c])
+            for c in commands
+        },
+    }
+
+
+def compare(baseline, result):
+    """Короткий звіт про зміну ключових метрик відносно попереднього прогону."""
+    rows = [
+        ("throughput_cmd_s", baseline.get("throughput_cmd_s"), result.get("throughput_cmd_s")),
+        ("dropped", baseline.get("dropped"), result.get("dropped")),
+        ("errors", baseline.get("errors"), result.get("errors")),
+    ]
+    for key in ("p50_ms", "p99_ms", "max_ms"):
+        rows.append((key, baseline["latency"].get(key), result["latency"].get(key)))
+    for name, old, new in rows:
+        if old is None or new is None:
+            continue
+        delta = (new - old) / old * 100.0 if old else 0.0
+        print("%-18s %10.3f -> %10.3f  (%+.1f%%)" % (name, old, new, delta), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="послідовний порт або pty")
+    parser.add_argument("--baud", type=int, default=9600, choices=sorted(BAUD_RATES))
+    parser.add_argument("--mix", default="L=50", help="команди з вагами: 'L=10:4,STATS:1'")
+    parser.add_argument("--rate", type=float, default=10.0, help="команд за секунду, 0 - без обмеження")
+    parser.add_argument("--burst", type=int, default=1, help="команд у пачці")
+    parser.add_argument("--gap", type=float, default=0.0, help="додаткова пауза між пачками, с")
+    parser.add_argument("--window", type=int, default=8, help="макс. команд без відповіді")
+    parser.add_argument("--count", type=int, default=200)
+    parser.add_argument("--timeout", type=float, default=1.0, help="очікування відповіді, с")
+    parser.add_argument("--address", type=lambda v: int(v, 0), help="адресний байт шини (0x80..0xFF)")
+    parser.add_argument("--reply-mode", type=int, default=2, choices=(0, 1, 2),
+                        help="режим відповідей прошивки (V=): 0 - тихий, 1 - коди, 2 - текст")
+    parser.add_argument("--wake-gap", type=float, default=0.05,
+                        help="пауза, після якої перед командою йде '\\n' пробудження, с "
+                             "(POWER_STOP_MIN_MS); 0 - ніколи")
+    parser.add_argument("--wake-delay", type=float, default=0.002,
+                        help="затримка після байта пробудження, с")
+    parser.add_argument("--histogram", default=HISTOGRAM_MS,
+                        help="межі кошиків гістограми затримок, мс: '1,2,5,10'")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--json", help="файл для результатів (за замовчуванням stdout)")
+    parser.add_argument("--baseline", help="JSON попереднього прогону для порівняння")
+    args = parser.parse_args()
+
+    result = run(args)
+    if args.baseline:
+        with open(args.baseline) as previous:
+            compare(json.load(previous), result)
+    text = json.dumps(result, indent=2, sort_keys=True)
+    if args.json:
+        with open(args.json, "w") as out:
+            out.write(text + "\n")
+    else:
+        print(text)
+    return 1 if result["dropped"] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
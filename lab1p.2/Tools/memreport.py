@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""Звіт про використання flash і RAM за map-файлом лінкера.
+
+Розбирає map-файл GNU ld (CubeIDE створює його поруч з ELF) і файли .su
+компілятора (-fstack-usage): розміри за секціями, об'єктними файлами й
+групами (застосунок, HAL, CMSIS, newlib, libgcc), найбільші функції та
+дані (за іменами секцій -ffunction-sections/-fdata-sections) і найбільші
+кадри стека. Звіт не містить адрес і часу, рядки впорядковані за
+розміром, а потім за іменем, тож його можна порівнювати diff'ом між
+комітами. Якщо задано бюджет і його перевищено, код виходу - 1, і
+збірка в CubeIDE завершується помилкою.
+
+Приклад (крок після збірки, каталог Debug):
+    memreport.py lab1p.2.map --su . --budget ../Tools/memory_budget.json \
+        --out memory_report.txt
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+from collections import defaultdict
+
+# Вихідні секції, що займають flash, RAM або обидві (.data: образ у flash,
+# копія в RAM)
+FLASH_SECTIONS = {".isr_vector", ".text", ".rodata", ".ARM.extab", ".ARM",
+                  ".preinit_array", ".init_array", ".fini_array"}
+RAM_SECTIONS = {".bss", ".noinit", "._user_heap_stack"}
+BOTH_SECTIONS = {".data"}
+
+# Заголовок вихідної секції; в .data ld додає "load address" (адреса у flash)
+OUTPUT_SECTION = re.compile(r"^(\.[\w.]+)(?:\s+0x[0-9a-f]+\s+0x[0-9a-f]+(?: load address 0x[0-9a-f]+)?)?\s*$")
+# Адреса і розмір вихідної секції з довгим ім'ям - окремим рядком після імені
+OUTPUT_ADDRESS = re.compile(r"^\s+0x[0-9a-f]+\s+0x[0-9a-f]+(?: load address 0x[0-9a-f]+)?\s*$")
+INPUT_SECTION = re.compile(r"^ (\.[^\s]+|COMMON)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+INPUT_NAME_ONLY = re.compile(r"^ (\.[^\s]+|COMMON)\s*$")
+FILL = re.compile(r"^ \*fill\*\s+0x[0-9a-f]+\s+0x([0-9a-f]+)")
+ARCHIVE_MEMBER = re.compile(r"^(.*?)([^/\\]+\.a)\((.+)\)$")
+
+
+def group_of(obj):
+    """Група для об'єктного файлу або члена бібліотеки."""
+    path = obj.replace("\\", "/")
+    member = ARCHIVE_MEMBER.match(path)
+    if member:
+        library = member.group(2)
+        if library.startswith(("libc", "libm", "libnosys", "libg")) and library != "libgcc.a":
+            return "newlib"
+        if library == "libgcc.a":
+            return "libgcc"
+        return library
+    path = "/" + path
+    if "/STM32F4xx_HAL_Driver/" in path:
+        return "hal"
+    if "/CMSIS/" in path or "system_stm32f4xx" in path:
+        return "cmsis"
+    if "/Startup/" in path or "crt" in os.path.basename(path):
+        return "startup"
+    if "/Core/" in path:
+        return "app"
+    return "other"
+
+
+def short_name(obj):
+    """Ім'я об'єкта без каталогу збірки і шляху до тулчейна."""
+    path = obj.replace("\\", "/")
+    member = ARCHIVE_MEMBER.match(path)
+    if member:
+        return "%s(%s)" % (member.group(2), member.group(3))
+    return path[2:] if path.startswith("./") else os.path.basename(path)
+
+
+def regions_of(section):
+    if section in FLASH_SECTIONS:
+        return ("flash",)
+    if section in RAM_SECTIONS:
+        return ("ram",)
+    if section in BOTH_SECTIONS:
+        return ("flash", "ram")
+    return ()
+
+
+def parse_map(path):
+    """Вхідні секції: (вихідна секція, вхідна секція, об'єкт, розмір)."""
+    entries = []
+    with open(path, encoding="utf-8", errors="replace") as handle:
+        lines = handle.read().splitlines()
+    try:
+        start = lines.index("Linker script and memory map")
+    except ValueError:
+        start = 0
+
+    output = None
+    pending = None  # Довге ім'я вхідної секції, адреса на наступному рядку
+    for line in lines[start:]:
+        if line.startswith("/DISCARD/"):
+            output = None
+            continue
+        match = OUTPUT_SECTION.match(line)
+        if match and not line.startswith(" "):
+            output = match.group(1)
+            pending = None
+            continue
+        if output is None or not regions_of(output):
+            continue
+        if OUTPUT_ADDRESS.match(line):
+            continue
+        match = FILL.match(line)
+        if match:
+            entries.append((output, "*fill*", "*fill*", int(match.group(1), 16)))
+            continue
+        match = INPUT_NAME_ONLY.match(line)
+        if match:
+            pending = match.group(1)
+            continue
+        match = INPUT_SECTION.match(line)
+        if match:
+            name = match.group(1) or pending
+            pending = None
+            size = int(match.group(3), 16)
+            obj = match.group(4).strip()
+            if name is None or size == 0 or obj.startswith("0x"):
+                continue  # Рядок символу, а не секції
+            entries.append((output, name, obj, size))
+    return entries
+
+
+def parse_stack_usage(root):
+    """Кадри стека з файлів .su: (функція, байти, тип)."""
+    frames = []
+    for directory, _, files in os.walk(root):
+        for name in sorted(files):
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(directory, name), encoding="utf-8", errors="replace") as handle:
+                for line in handle:
+                    fields = line.rstrip("\n").split("\t")
+                    if len(fields) < 3:
+                        continue
+                    location = fields[0]
+                    function = location.rsplit(":", 1)[-1]
+                    source = location.split(":", 1)[0]
+                    frames.append(("%s:%s" % (os.path.basename(source), function),
+                                   int(fields[1]), fields[2]))
+    return frames
+
+
+def symbol_of(section):
+    """Ім'я функції або змінної з імені вхідної секції."""
+    for prefix in (".text.", ".rodata.", ".data.", ".bss.", ".RamFunc."):
+        if section.startswith(prefix):
+            return section[len(prefix):]
+    return None
+
+
+def sorted_sizes(sizes):
+    return sorted(sizes.items(), key=lambda item: (-item[1], item[0]))
+
+
+def build_report(entries, frames, top):
+    totals = defaultdict(int)
+    sections = defaultdict(int)
+    groups = defaultdict(lambda: defaultdict(int))
+    objects = defaultdict(lambda: defaultdict(int))
+    symbols = {}
+
+    for output, name, obj, size in entries:
+        sections[output] += size
+        for region in regions_of(output):
+            totals[region] += size
+            if obj != "*fill*":
+                groups[group_of(obj)][region] += size
+                objects[short_name(obj)][region] += size
+        symbol = symbol_of(name)
+        if symbol and obj != "*fill*":
+            key = "%s %s" % (output, symbol)
+            symbols[key] = symbols.get(key, 0) + size
+
+    # Код у SRAM (__RAM_FUNC) лежить у .data: і у flash, і в RAM
+    ram_code = sum(size for output, name, obj, size in entries if name.startswith(".RamFunc"))
+    lines = ["TOTAL flash=%d ram=%d ramfunc=%d" % (totals["flash"], totals["ram"], ram_code),
+             "", "SECTIONS"]
+    for name, size in sorted_sizes(sections):
+        lines.append("  %-20s %8d" % (name, size))
+
+    lines += ["", "GROUPS%25s %8s" % ("flash", "ram")]
+    for name in sorted(groups, key=lambda g: (-groups[g]["flash"] - groups[g]["ram"], g)):
+        lines.append("  %-20s %8d %8d" % (name, groups[name]["flash"], groups[name]["ram"]))
+
+    lines += ["", "OBJECTS%44s %8s" % ("flash", "ram")]
+    for name in sorted(objects, key=lambda o: (-objects[o]["flash"] - objects[o]["ram"], o)):
+        lines.append("  %-40s %8d %8d" % (name, objects[name]["flash"], objects[name]["ram"]))
+
+    lines += ["", "SYMBOLS (top %d)" % top]
+    for name, size in sorted_sizes(symbols)[:top]:
+        lines.append("  %-50s %8d" % (name, size))
+
+    if frames:
+        lines += ["", "STACK (top %d)" % top]
+        for function, size, kind in sorted(frames, key=lambda f: (-f[1], f[0]))[:top]:
+            lines.append("  %-50s %8d %s" % (function, size, kind))
+
+    return "\n".join(lines) + "\n", totals, groups, frames
+
+
+def check_budget(budget, totals, groups, frames):
+    """Список порушень бюджету (порожній - усе в межах)."""
+    violations = []
+    for region in ("flash", "ram"):
+        limit = budget.get(region)
+        if limit is not None and totals[region] > limit:
+            violations.append("%s: %d > %d" % (region, totals[region], limit))
+    for group, limits in sorted(budget.get("groups", {}).items()):
+        for region, limit in sorted(limits.items()):
+            used = groups.get(group, {}).get(region, 0)
+            if used > limit:
+                violations.append("%s %s: %d > %d" % (group, region, used, limit))
+    frame_limit = budget.get("stack_frame")
+    if frame_limit is not None:
+        for function, size, kind in sorted(frames, key=lambda f: (-f[1], f[0])):
+            if size > frame_limit:
+                violations.append("stack %s: %d > %d" % (function, size, frame_limit))
+            if "dynamic" in kind and budget.get("forbid_dynamic_stack"):
+                violations.append("stack %s: dynamic frame" % function)
+    return violations
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="map-файл лінкера")
+    parser.add_argument("--su", help="каталог з файлами .su (-fstack-usage)")
+    parser.add_argument("--budget", help="JSON з лімітами flash/ram, груп і кадру стека")
+    parser.add_argument("--top", type=int, default=20, help="рядків у списках символів і стека")
+    parser.add_argument("--out", help="файл звіту (за замовчуванням stdout)")
+    args = parser.parse_args()
+
+    entries = parse_map(args.map)
+    frames = parse_stack_usage(args.su) if args.su else []
+    report, totals, groups, frames = build_report(entries, frames, args.top)
+
+    violations = []
+    if args.budget:
+        with open(args.budget, encoding="utf-8") as handle:
+            violations = check_budget(json.load(handle), totals, groups, frames)
+        report += "\nBUDGET %s\n" % ("exceeded" if violations else "ok")
+        report += "".join("  %s\n" % violation for violation in violations)
+
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as handle:
+            handle.write(report)
+        print("flash=%d ram=%d budget=%s" % (totals["flash"], totals["ram"],
+                                             "exceeded" if violations else "ok"))
+    else:
+        sys.stdout.write(report)
+    for violation in violations:
+        print("memreport: budget exceeded: %s" % violation, file=sys.stderr)
+    return 1 if violations else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())